@@ -82,6 +82,10 @@ public enum WindowMessage
     /// </summary>
     SyncPaint = 0x88,
     /// <summary>
+    /// A window message corresponding to WM_INPUT, sent to a window registered for raw input when a device generates input.
+    /// </summary>
+    Input = 0xFF,
+    /// <summary>
     /// A window message corresponding to a nonsystem key being pressed (WM_KEYDOWN). A nonsystem key is a key that is pressed
     /// when the ALT key is not pressed.
     /// </summary>
@@ -11,20 +11,548 @@
 // </copyright>
 // -----------------------------------------------------------------------
 
+#include <memory>
+#include <vector>
+
 #include "Hooks.h"
+#include "EventStampRing.h"
+#include "KeyboardState.h"
+#include "RawInputTranslator.h"
 #include "SharedData.h"
 
+static_assert(sizeof(RawInputHeader) == sizeof(RAWINPUTHEADER), "RawInputHeader must match the layout of RAWINPUTHEADER.");
+static_assert(sizeof(RawKeyboardInput) == sizeof(RAWKEYBOARD), "RawKeyboardInput must match the layout of RAWKEYBOARD.");
+static_assert(sizeof(RawMouseInput) == sizeof(RAWMOUSE), "RawMouseInput must match the layout of RAWMOUSE.");
+
 namespace {
     HINSTANCE Instance;
-    
-    LRESULT SendHookMessage(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+
+    // Keyboard state is maintained per thread, just like the system's own, and separately for each type of keyboard
+    // hook procedure so that a thread with both installed doesn't apply the same keystroke twice.
+    thread_local KeyboardState KeyboardHookState;
+    thread_local KeyboardState LowLevelKeyboardHookState;
+    // The tick count at which the thread's keyboard hook procedure last saw a keystroke.
+    thread_local DWORD LastKeyboardHookTime;
+    // Raw input is only ever delivered to the thread that owns the window registered for it.
+    thread_local RawInputTranslator RawInputState;
+    // The payload index of the hook event whose parameters a destination thread last read, and may be changing.
+    thread_local LONG DispatchedPayloadIndex;
+
+    /**
+     * Associates a destination window with the queue of event stamps being passed to it by a low-level hook procedure.
+     */
+    struct EventTrace
+    {
+        HookType Type;
+        HWND Destination;
+        DWORD ProducerThreadId;
+        int ReferenceCount;
+        std::unique_ptr<EventStampRing> Stamps;
+    };
+
+    /**
+     * The maximum number of destination windows that events can be traced to at one time in a single process.
+     */
+    constexpr int MaxEventTraces = MaxDestinations * 8;
+
+    // Low-level hook procedures run on the thread that installed them, so their event stamps can be passed through
+    // process-local memory rather than the shared data segment. Each hook type and destination pair gets its own queue,
+    // so that hook sources installed on different threads never share one.
+    EventTrace EventTraces[MaxEventTraces];
+    SRWLOCK EventTracesLock = SRWLOCK_INIT;
+
+    /**
+     * The maximum number of raw input blocks read from the input buffer at one time.
+     */
+    constexpr UINT RawInputBatchSize = 64;
+    /**
+     * The number of bytes separating a buffered raw input block's header from its device data in 32-bit processes running
+     * on 64-bit Windows, where the buffer is filled using the 64-bit layout.
+     */
+    constexpr size_t Wow64HeaderPadding = 8;
+    /**
+     * The number of milliseconds a keyboard hook procedure can go without seeing a keystroke before its key states are
+     * resynced, as the keyboard focus may have been with another thread in the meantime.
+     */
+    constexpr DWORD KeyboardResyncInterval = 1000;
+    /**
+     * The number of bits a low-level keyboard event's flags are shifted by when packed above its virtual-key code and
+     * keyboard modifiers in the \c lParam of its hook event message.
+     */
+    constexpr int InlineKeyboardFlagsShift = 24;
+
+    static_assert(KeyboardModifiersShift + 8 <= InlineKeyboardFlagsShift,
+                  "Keyboard modifiers must fit below the flags of a low-level keyboard event.");
+
+    WPARAM PackHookEventHeader(HookType hookType, UINT message, HookEventAttributes attributes = NoEventAttributes)
+    {   // Message identifiers above 0xFFFF are reserved by the system, so the bottom 16 bits are all a message ever needs.
+        return hookType
+            | static_cast<WPARAM>(message & 0xFFFF) << HookEventMessageShift
+            | static_cast<WPARAM>(attributes) << HookEventAttributesShift;
+    }
+
+    LONG SendHookMessage(HWND hWnd,
+                         HookType hookType,
+                         UINT message,
+                         WPARAM wParam,
+                         LPARAM lParam,
+                         HookEventAttributes attributes = NoEventAttributes)
+    {   // The payload index is handed back so that hook procedures able to modify messages can read back any changes.
+        LONG payloadIndex = StoreHookEventPayload(wParam, lParam);
+
+        SendMessage(hWnd, GetHookEventMessage(), PackHookEventHeader(hookType, message, attributes), payloadIndex);
+
+        return payloadIndex;
+    }
+
+    BOOL PostHookMessage(HWND hWnd, HookType hookType, UINT message, LPARAM parameters)
+    {   // Posted hook events carry their parameters in the message itself, as a destination may read them long after the
+        // payload ring shared with every other hook procedure has come back around.
+        return PostMessage(hWnd, GetHookEventMessage(), PackHookEventHeader(hookType, message), parameters);
+    }
+
+    bool CarriesInlinePayload(HookType hookType)
+    {   // Only low-level hook procedures post their events rather than send them.
+        return hookType == LowLevelKeyboard || hookType == LowLevelMouse;
+    }
+
+    LPARAM PackLowLevelKeyboardEvent(WPARAM keyboardDetails, DWORD flags)
+    {
+        return static_cast<LPARAM>(keyboardDetails | static_cast<WPARAM>(flags & 0xFF) << InlineKeyboardFlagsShift);
+    }
+
+    LPARAM PackLowLevelMouseEvent(LONG x, LONG y)
+    {   // Like the system's own mouse messages, screen coordinates are packed as signed 16-bit values.
+        return static_cast<LPARAM>(static_cast<WPARAM>(x & 0xFFFF) | static_cast<WPARAM>(y & 0xFFFF) << 16);
+    }
+
+    void UnpackInlinePayload(HookType hookType, LPARAM parameters, HookEventPayload* payload)
+    {
+        auto packed = static_cast<WPARAM>(parameters) & 0xFFFFFFFF;
+
+        if (hookType == LowLevelKeyboard)
+        {
+            payload->WParam = packed & ((static_cast<WPARAM>(1) << InlineKeyboardFlagsShift) - 1);
+            payload->LParam = static_cast<LPARAM>(packed >> InlineKeyboardFlagsShift);
+        }
+        else
+        {
+            payload->WParam = static_cast<WPARAM>(static_cast<short>(packed & 0xFFFF));
+            payload->LParam = static_cast<short>(packed >> 16 & 0xFFFF);
+        }
+    }
+
+    bool TracesEvents(HookType hookType, HookOptions options)
+    {   // Only low-level hook procedures stamp the events they capture.
+        return (hookType == LowLevelKeyboard || hookType == LowLevelMouse) && (options & TraceEvents) == TraceEvents;
+    }
+
+    EventStampRing* FindEventStamps(HookType hookType, HWND destination)
+    {
+        if (destination == nullptr)
+            return nullptr;
+
+        EventStampRing* stamps = nullptr;
+
+        AcquireSRWLockShared(&EventTracesLock);
+
+        for (const EventTrace& eventTrace : EventTraces)
+        {
+            if (eventTrace.Type == hookType && eventTrace.Destination == destination)
+            {
+                stamps = eventTrace.Stamps.get();
+                break;
+            }
+        }
+
+        ReleaseSRWLockShared(&EventTracesLock);
+
+        return stamps;
+    }
+
+    EventTrace* AcquireEventTrace(HookType hookType, HWND destination)
+    {
+        DWORD threadId = GetCurrentThreadId();
+        EventTrace* freeTrace = nullptr;
+
+        for (EventTrace& eventTrace : EventTraces)
+        {
+            if (eventTrace.Type == hookType && eventTrace.Destination == destination)
+            {   // A queue can only ever have the one thread pushing to it. Stamps left over from an earlier hook procedure
+                // still belong to messages in the destination's queue, so the queue is kept as is.
+                if (eventTrace.ReferenceCount > 0 && eventTrace.ProducerThreadId != threadId)
+                    return nullptr;
+
+                eventTrace.ProducerThreadId = threadId;
+                eventTrace.ReferenceCount++;
+
+                return &eventTrace;
+            }
+
+            // A queue no longer being pushed to can only be taken over once its destination is gone, as until then the
+            // destination may still be popping from it.
+            if (freeTrace == nullptr
+                && (eventTrace.Destination == nullptr
+                    || eventTrace.ReferenceCount == 0 && !IsWindow(eventTrace.Destination)))
+            {
+                freeTrace = &eventTrace;
+            }
+        }
+
+        if (freeTrace == nullptr)
+            return nullptr;
+
+        // Stamp queues are kept for the life of the process once allocated, as a destination may still be reading from
+        // one after its hook procedure has been removed.
+        if (freeTrace->Stamps == nullptr)
+            freeTrace->Stamps = std::make_unique<EventStampRing>();
+
+        freeTrace->Stamps->Reset();
+        freeTrace->Type = hookType;
+        freeTrace->Destination = destination;
+        freeTrace->ProducerThreadId = threadId;
+        freeTrace->ReferenceCount = 1;
+
+        return freeTrace;
+    }
+
+    void AcquireEventTraces(HookType hookType, const HWND* destinations, int destinationCount, HookOptions options)
+    {   // Destinations that can't be given a queue still receive their events, just without stamps.
+        if (!TracesEvents(hookType, options))
+            return;
+
+        AcquireSRWLockExclusive(&EventTracesLock);
+
+        for (int i = 0; i < destinationCount; i++)
+        {
+            AcquireEventTrace(hookType, destinations[i]);
+        }
+
+        ReleaseSRWLockExclusive(&EventTracesLock);
+    }
+
+    void ReleaseEventTraces(HookType hookType, const HookData* hookData)
     {
-        return SendMessage(hWnd, message + WM_USER, wParam, lParam);
+        if (hookData->Handle == nullptr || !TracesEvents(hookType, hookData->Options))
+            return;
+
+        AcquireSRWLockExclusive(&EventTracesLock);
+
+        for (int i = 0; i < hookData->DestinationCount; i++)
+        {
+            for (EventTrace& eventTrace : EventTraces)
+            {
+                if (eventTrace.Type == hookType
+                    && eventTrace.Destination == hookData->Destinations[i]
+                    && eventTrace.ReferenceCount > 0)
+                {
+                    eventTrace.ReferenceCount--;
+                    break;
+                }
+            }
+        }
+
+        ReleaseSRWLockExclusive(&EventTracesLock);
     }
 
-    BOOL PostHookMessage(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+    void PostInputHookMessage(
+        HookType hookType, HookData* hookData, HWND destination, UINT message, LPARAM parameters, DWORD time)
     {
-        return PostMessage(hWnd, message + WM_USER, wParam, lParam);
+        LONG sequence = InterlockedIncrement(&hookData->EventSequence);
+        EventStampRing* stamps = nullptr;
+
+        if ((hookData->Options & TraceEvents) == TraceEvents)
+            stamps = FindEventStamps(hookType, destination);
+
+        if (stamps != nullptr)
+        {
+            LARGE_INTEGER now;
+            QueryPerformanceCounter(&now);
+
+            EventStamp stamp { static_cast<std::int32_t>(sequence), static_cast<std::uint32_t>(time), now.QuadPart };
+
+            if (!stamps->TryPush(stamp))
+            {   // A full stamp queue means the destination has fallen thousands of events behind. Rather than let stamps
+                // fall out of step with their messages, we drop the event, which the listener will see as a sequence gap.
+                InterlockedIncrement(&hookData->DroppedEventCount);
+                return;
+            }
+        }
+
+        // Posting typically fails because the destination's queue has reached its limit on posted messages. The event is
+        // lost either way, but at least now it's counted.
+        if (!PostHookMessage(destination, hookType, message, parameters))
+        {
+            if (stamps != nullptr)
+                stamps->Retract();
+
+            InterlockedIncrement(&hookData->DroppedEventCount);
+        }
+    }
+
+    void SeedKeyboardState(KeyboardState& state)
+    {   // Hook procedures that see all keyboard input only query the actual keyboard state this one time; from here on
+        // out, the state is maintained purely from the keyboard input events we see.
+        if (state.IsSeeded())
+            return;
+
+        unsigned int heldKeys = 0;
+        unsigned int toggles = NoModifiers;
+
+        for (int bit = 0; bit < static_cast<int>(std::size(KeyboardState::TrackedKeys)); bit++)
+        {
+            if ((GetAsyncKeyState(static_cast<int>(KeyboardState::TrackedKeys[bit])) & 0x8000) != 0)
+                heldKeys |= 1U << bit;
+        }
+
+        if ((GetKeyState(VK_CAPITAL) & 0x1) != 0)
+            toggles |= CapsLockToggled;
+
+        if ((GetKeyState(VK_NUMLOCK) & 0x1) != 0)
+            toggles |= NumLockToggled;
+
+        if ((GetKeyState(VK_SCROLL) & 0x1) != 0)
+            toggles |= ScrollLockToggled;
+
+        state.Seed(heldKeys, static_cast<KeyboardModifiers>(toggles));
+    }
+
+    void ResyncKeyboardState(KeyboardState& state)
+    {   // WH_KEYBOARD hook procedures only see the keystrokes retrieved by the hooked thread, so anything pressed or released
+        // while another thread had the keyboard focus has to be picked up from the thread's own key states, which reflect
+        // all input up to, but not including, the event being hooked. This is only done when input may have been missed,
+        // with the key states otherwise maintained purely from the keystrokes we see.
+        BYTE keys[256];
+
+        if (!GetKeyboardState(keys))
+        {
+            SeedKeyboardState(state);
+            return;
+        }
+
+        unsigned int heldKeys = 0;
+        unsigned int toggles = NoModifiers;
+
+        for (int bit = 0; bit < static_cast<int>(std::size(KeyboardState::TrackedKeys)); bit++)
+        {
+            if ((keys[KeyboardState::TrackedKeys[bit]] & 0x80) != 0)
+                heldKeys |= 1U << bit;
+        }
+
+        if ((keys[VK_CAPITAL] & 0x1) != 0)
+            toggles |= CapsLockToggled;
+
+        if ((keys[VK_NUMLOCK] & 0x1) != 0)
+            toggles |= NumLockToggled;
+
+        if ((keys[VK_SCROLL] & 0x1) != 0)
+            toggles |= ScrollLockToggled;
+
+        state.Resync(heldKeys, static_cast<KeyboardModifiers>(toggles));
+    }
+
+    void InvalidateKeyboardState(UINT message)
+    {   // Focus and activation changes are sent to the thread's windows, so a thread that also has a WH_CALLWNDPROC hook
+        // procedure learns it may be missing keystrokes without having to wait for a lull in its input.
+        if (message == WM_SETFOCUS || message == WM_KILLFOCUS || message == WM_ACTIVATE || message == WM_ACTIVATEAPP)
+            KeyboardHookState.Invalidate();
+    }
+
+    KeyboardModifiers UpdateKeyboardState(
+        KeyboardState& state, unsigned int virtualKey, bool isKeyUp, bool isExtended, unsigned int scanCode)
+    {
+        SeedKeyboardState(state);
+
+        return state.Update(virtualKey, isKeyUp, isExtended, scanCode);
+    }
+
+    WPARAM PackKeyboardModifiers(WPARAM virtualKey, KeyboardModifiers modifiers)
+    {
+        return virtualKey | static_cast<WPARAM>(modifiers) << KeyboardModifiersShift;
+    }
+
+    HHOOK InstallHookProcedure(HookType hookType, int threadId)
+    {
+        int idHook;
+        HOOKPROC lpfn;
+
+        switch (hookType)
+        {
+            case CallWindowProcedure:
+                idHook = WH_CALLWNDPROC;
+                lpfn = CallWndProc;
+                break;
+
+            case CallWindowProcedureReturn:
+                idHook = WH_CALLWNDPROCRET;
+                lpfn = CallWndProcRet;
+                break;
+
+            case GetMessages:
+                idHook = WH_GETMESSAGE;
+                lpfn = GetMsgProc;
+                break;
+
+            case Keyboard:
+                idHook = WH_KEYBOARD;
+                lpfn = KeyboardProc;
+                break;
+
+            case LowLevelKeyboard:
+                idHook = WH_KEYBOARD_LL;
+                lpfn = LowLevelKeyboardProc;
+                break;
+
+            case Mouse:
+                idHook = WH_MOUSE;
+                lpfn = MouseProc;
+                break;
+
+            case LowLevelMouse:
+                idHook = WH_MOUSE_LL;
+                lpfn = LowLevelMouseProc;
+                break;
+
+            default:
+                return nullptr;
+        }
+
+        return SetWindowsHookEx(idHook, lpfn, Instance, threadId);
+    }
+
+    void StoreHookData(HookData* hookData,
+                       HHOOK hook,
+                       const HWND* destinations,
+                       int destinationCount,
+                       ShardingPolicy policy,
+                       HookOptions options,
+                       int owner)
+    {
+        hookData->Handle = hook;
+        hookData->Options = options;
+        hookData->Sharding = policy;
+        hookData->DestinationCount = destinationCount;
+        hookData->OwnerProcessId = GetCurrentProcessId();
+        hookData->Owner = owner;
+
+        for (int i = 0; i < destinationCount; i++)
+        {
+            hookData->Destinations[i] = destinations[i];
+        }
+    }
+
+    bool DescribeRawInputDevice(HookType hookType, RAWINPUTDEVICE& device)
+    {
+        device.usUsagePage = 0x01; // HID_USAGE_PAGE_GENERIC
+
+        switch (hookType)
+        {
+            case LowLevelKeyboard:
+                device.usUsage = 0x06; // HID_USAGE_GENERIC_KEYBOARD
+                return true;
+
+            case LowLevelMouse:
+                device.usUsage = 0x02; // HID_USAGE_GENERIC_MOUSE
+                return true;
+
+            default:
+                return false;
+        }
+    }
+
+    size_t GetRawInputBufferPadding()
+    {
+#ifdef _WIN64
+        return 0;
+#else
+        static const size_t padding = []
+        {
+            BOOL isWow64 = FALSE;
+
+            return IsWow64Process(GetCurrentProcess(), &isWow64) && isWow64 ? Wow64HeaderPadding : 0;
+        }();
+
+        return padding;
+#endif
+    }
+
+    bool ApplyReservedHookChanges(HookChange* changes, int changeCount, HookData** hookData, int owner)
+    {   // New hook data is staged locally until the batch is committed, as an installation may be taking over the hook
+        // data of a hook procedure that remains installed until its uninstallation is applied below.
+        std::vector<HookData> installedData(changeCount);
+
+        for (int i = 0; i < changeCount; i++)
+        {
+            HookChange& change = changes[i];
+
+            if (change.Action != InstallHook)
+                continue;
+
+            HHOOK hook = InstallHookProcedure(change.Type, change.ThreadId);
+
+            if (hook == nullptr)
+            {   // Abandon the batch by undoing the installations made so far. Nothing has been uninstalled yet.
+                for (int j = 0; j < i; j++)
+                {
+                    if (changes[j].Succeeded)
+                        UnhookWindowsHookEx(installedData[j].Handle);
+
+                    changes[j].Succeeded = false;
+                }
+
+                CommitHookData(changes, changeCount, hookData, installedData.data());
+                return false;
+            }
+
+            StoreHookData(&installedData[i], hook, &change.Destination, 1, ShardByThread, change.Options, owner);
+            change.Succeeded = true;
+        }
+
+        bool applied = true;
+
+        for (int i = 0; i < changeCount; i++)
+        {
+            HookChange& change = changes[i];
+
+            if (change.Action != UninstallHook)
+                continue;
+
+            change.Succeeded = UnhookWindowsHookEx(hookData[i]->Handle);
+
+            if (change.Succeeded)
+                continue;
+
+            applied = false;
+
+            // A hook procedure that refuses to be uninstalled keeps its hook data, so any reinstallation meant to replace
+            // it must be undone.
+            for (int j = 0; j < changeCount; j++)
+            {
+                if (changes[j].Action == InstallHook && changes[j].Succeeded && hookData[j] == hookData[i])
+                {
+                    UnhookWindowsHookEx(installedData[j].Handle);
+                    changes[j].Succeeded = false;
+                }
+            }
+        }
+
+        // As when adding a hook, stamp queues are acquired for the new hook procedures before the uninstalled ones
+        // release theirs, and while the uninstalled hook data still describes its destinations.
+        for (int i = 0; i < changeCount; i++)
+        {
+            if (changes[i].Action == InstallHook && changes[i].Succeeded)
+                AcquireEventTraces(changes[i].Type, &changes[i].Destination, 1, changes[i].Options);
+        }
+
+        for (int i = 0; i < changeCount; i++)
+        {
+            if (changes[i].Action == UninstallHook && changes[i].Succeeded)
+                ReleaseEventTraces(changes[i].Type, hookData[i]);
+        }
+
+        CommitHookData(changes, changeCount, hookData, installedData.data());
+
+        return applied;
     }
 }
 
@@ -50,66 +578,43 @@ BOOL APIENTRY DllMain(HINSTANCE instance, DWORD reason, LPVOID)  // NOLINT(misc-
 	return TRUE;    
 }
 
-bool __cdecl AddHook(HookType hookType, HWND destination, int threadId)
+bool __cdecl AddHook(HookType hookType, HWND destination, int threadId, HookOptions options)
 {
-    HookData* hookData = AddHookData(hookType, threadId);
+    return AddShardedHook(hookType, &destination, 1, ShardByThread, threadId, options);
+}
 
-    if (hookData == nullptr)
+bool __cdecl AddShardedHook(HookType hookType,
+                            const HWND* destinations,
+                            int destinationCount,
+                            ShardingPolicy policy,
+                            int threadId,
+                            HookOptions options)
+{
+    if (destinations == nullptr || destinationCount < 1 || destinationCount > MaxDestinations)
         return false;
 
-    int idHook;
-    HOOKPROC lpfn;
-
-    switch (hookType)
-    {
-    	case CallWindowProcedure:
-            idHook = WH_CALLWNDPROC;
-            lpfn = CallWndProc;
-            break;
-
-    	case CallWindowProcedureReturn:
-            idHook = WH_CALLWNDPROCRET;
-            lpfn = CallWndProcRet;
-            break;
-    	
-		case GetMessages:
-			idHook = WH_GETMESSAGE;
-			lpfn = GetMsgProc;
-			break;
-
-        case Keyboard:
-            idHook = WH_KEYBOARD;
-            lpfn = KeyboardProc;
-            break;
-
-		case LowLevelKeyboard:
-            idHook = WH_KEYBOARD_LL;
-            lpfn = LowLevelKeyboardProc;
-            break;
-
-		case Mouse:
-            idHook = WH_MOUSE;
-            lpfn = MouseProc;
-            break;
-
-        case LowLevelMouse:
-            idHook = WH_MOUSE_LL;
-            lpfn = LowLevelMouseProc;
-            break;
+    HookData* hookData = AddHookData(hookType, threadId);
 
-		default:
-            return false;
-    }
+    if (hookData == nullptr)
+        return false;
 
-    HHOOK hook = SetWindowsHookEx(idHook, lpfn, Instance, threadId);
+    HHOOK hook = InstallHookProcedure(hookType, threadId);
 
     if (hook == nullptr)
-    {        
+    {   // Don't leave a thread we failed to hook taking up space, unless a hook procedure was already installed into it.
+        if (hookData->Handle == nullptr)
+            RemoveHookData(hookType, threadId);
+
         return false;
     }
 
-    hookData->Handle = hook;
-    hookData->Destination = destination;
+    // Low-level hook procedures aren't called until this thread next pumps messages, so the stamp queues are in place by
+    // the time any event is captured. They're acquired before those of any replaced hook procedure are released, so that
+    // a destination kept across the replacement never has its queue taken away.
+    AcquireEventTraces(hookType, destinations, destinationCount, options);
+    ReleaseEventTraces(hookType, hookData);
+
+    StoreHookData(hookData, hook, destinations, destinationCount, policy, options, 0);
 
     return true;
 }
@@ -124,31 +629,261 @@ bool __cdecl RemoveHook(HookType hookType, int threadId)
     bool result = UnhookWindowsHookEx(hookData->Handle);
 
     if (result)
+    {
+        ReleaseEventTraces(hookType, hookData);
         RemoveHookData(hookType, threadId);
+    }
 
     return result;
 }
 
+bool __cdecl ApplyHookChanges(HookChange* changes, int changeCount, int owner)
+{
+    if (changes == nullptr || changeCount < 1 || changeCount > MaxHookDataCount * 2)
+        return false;
+
+    for (int i = 0; i < changeCount; i++)
+    {
+        changes[i].Succeeded = false;
+    }
+
+    std::vector<HookData*> hookData(changeCount);
+
+    if (!ReserveHookData(changes, changeCount, hookData.data()))
+        return false;
+
+    return ApplyReservedHookChanges(changes, changeCount, hookData.data(), owner);
+}
+
+int __cdecl RemoveOwnedHooks(int owner)
+{
+    HookChange changes[MaxHookDataCount];
+    HookData* hookData[MaxHookDataCount];
+    int changeCount = ReserveOwnedHookData(owner, changes, MaxHookDataCount, hookData);
+
+    if (changeCount == 0)
+        return 0;
+
+    ApplyReservedHookChanges(changes, changeCount, hookData, owner);
+
+    int removedCount = 0;
+
+    for (int i = 0; i < changeCount; i++)
+    {
+        if (changes[i].Succeeded)
+            removedCount++;
+    }
+
+    return removedCount;
+}
+
+UINT __cdecl GetHookEventMessage()
+{   // Every process registering the same name is given the same identifier, so hook procedures and their destinations
+    // agree on it without having to share it.
+    static const UINT message = RegisterWindowMessage(TEXT("BadEcho.Hooks.HookEvent"));
+
+    return message;
+}
+
+bool __cdecl ReadHookEventPayload(WPARAM header, LPARAM payloadIndex, HookEventPayload* payload)
+{
+    if (payload == nullptr)
+        return false;
+
+    auto hookType = static_cast<HookType>(header & 0xFF);
+
+    if (CarriesInlinePayload(hookType))
+    {   // There's no slot behind an inline payload, and so nothing for ChangeMessageDetails to change.
+        DispatchedPayloadIndex = 0;
+        UnpackInlinePayload(hookType, payloadIndex, payload);
+
+        return true;
+    }
+
+    DispatchedPayloadIndex = static_cast<LONG>(payloadIndex);
+
+    return LoadHookEventPayload(DispatchedPayloadIndex, payload);
+}
+
 void __cdecl ChangeMessageDetails(UINT message, WPARAM wParam, LPARAM lParam)
+{   // Changes travel back to the hook procedure through the payload slot of the hook event being handled, so hook
+    // procedures on different threads never see each other's changes.
+    ChangeHookEventPayload(DispatchedPayloadIndex, message, wParam, lParam);
+}
+
+bool __cdecl GetMessagePumpData(int threadId, PumpData* pumpData)
 {
-    ChangedMessage = message;
-    ChangedWParam = wParam;
-    ChangedLParam = lParam;
-    ChangeMessage = true;
+    PumpData* source = GetPumpData(threadId);
+
+    if (source == nullptr || pumpData == nullptr)
+        return false;
+
+    // A no-op compare exchange gives us an atomic read of 64-bit values on 32-bit platforms.
+    pumpData->LastPumpTime = InterlockedCompareExchange64(&source->LastPumpTime, 0, 0);
+    pumpData->LastProbeTime = InterlockedCompareExchange64(&source->LastProbeTime, 0, 0);
+    pumpData->ProbeResponseTime = InterlockedCompareExchange64(&source->ProbeResponseTime, 0, 0);
+    pumpData->RetrievalCount = source->RetrievalCount;
+    pumpData->PeekCount = source->PeekCount;
+
+    return true;
+}
+
+bool __cdecl GetRegistryContention(RegistryContention* contention)
+{
+    if (contention == nullptr)
+        return false;
+
+    contention->WaitCount = InterlockedCompareExchange64(&SharedSectionWaitCount, 0, 0);
+    contention->WaitTicks = InterlockedCompareExchange64(&SharedSectionWaitTicks, 0, 0);
+
+    return true;
+}
+
+bool __cdecl ProbeMessagePump(int threadId)
+{
+    PumpData* pumpData = GetPumpData(threadId);
+
+    if (pumpData == nullptr)
+        return false;
+
+    // The probe time is recorded before posting so that a thread quick enough to respond before we return
+    // still has its response counted against this probe.
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+
+    InterlockedExchange64(&pumpData->LastProbeTime, now.QuadPart);
+
+    return PostThreadMessage(static_cast<DWORD>(threadId), WM_NULL, 0, 0);
+}
+
+bool __cdecl RegisterRawInput(HookType hookType, HWND destination)
+{
+    RAWINPUTDEVICE device {};
+
+    if (destination == nullptr || !DescribeRawInputDevice(hookType, device))
+        return false;
+
+    // Input sink registration has the destination receive input regardless of what window has the focus, making this
+    // equivalent in scope to a global low-level hook.
+    device.dwFlags = RIDEV_INPUTSINK;
+    device.hwndTarget = destination;
+
+    return RegisterRawInputDevices(&device, 1, sizeof(device));
+}
+
+bool __cdecl UnregisterRawInput(HookType hookType)
+{
+    RAWINPUTDEVICE device {};
+
+    if (!DescribeRawInputDevice(hookType, device))
+        return false;
+
+    device.dwFlags = RIDEV_REMOVE;
+    device.hwndTarget = nullptr;
+
+    return RegisterRawInputDevices(&device, 1, sizeof(device));
+}
+
+int __cdecl ReadRawInput(HRAWINPUT input, InputEvent* events, int capacity)
+{
+    if (events == nullptr || capacity < static_cast<int>(RawInputTranslator::MaxEventsPerInput))
+        return -1;
+
+    SeedKeyboardState(RawInputState.Keyboard());
+
+    POINT cursor {};
+    GetCursorPos(&cursor);
+
+    auto eventCapacity = static_cast<size_t>(capacity);
+    size_t eventCount = 0;
+
+    if (input != nullptr)
+    {   // The raw input belonging to the WM_INPUT message currently being processed is not returned by
+        // GetRawInputBuffer, so it must be read on its own.
+        RAWINPUT data;
+        UINT size = sizeof(data);
+
+        if (GetRawInputData(input, RID_INPUT, &data, &size, sizeof(RAWINPUTHEADER)) != static_cast<UINT>(-1))
+        {
+            eventCount += RawInputState.TranslateBuffer(
+                &data, size, 1, 0, cursor.x, cursor.y, events, eventCapacity);
+        }
+    }
+
+    size_t padding = GetRawInputBufferPadding();
+    size_t blockSize = sizeof(RAWINPUT) + padding;
+
+    // This lives on the stack rather than in thread-local storage, which this DLL would otherwise add to every thread of
+    // every process it gets injected into, when only the listener thread ever reads raw input.
+    alignas(8) BYTE buffer[RawInputBatchSize * (sizeof(RAWINPUT) + Wow64HeaderPadding)];
+
+    // Every block could be mouse input translating into the maximum number of events, so we never read more blocks
+    // than we're guaranteed to have room for.
+    while (size_t blocksThatFit = (eventCapacity - eventCount) / RawInputTranslator::MaxEventsPerInput)
+    {
+        size_t blocksToRead = blocksThatFit < RawInputBatchSize ? blocksThatFit : RawInputBatchSize;
+        auto size = static_cast<UINT>(blocksToRead * blockSize);
+        UINT count = GetRawInputBuffer(reinterpret_cast<PRAWINPUT>(buffer), &size, sizeof(RAWINPUTHEADER));
+
+        if (count == 0 || count == static_cast<UINT>(-1))
+            break;
+
+        eventCount += RawInputState.TranslateBuffer(buffer,
+                                                    sizeof(buffer),
+                                                    count,
+                                                    padding,
+                                                    cursor.x,
+                                                    cursor.y,
+                                                    events + eventCount,
+                                                    eventCapacity - eventCount);
+    }
+
+    return static_cast<int>(eventCount);
+}
+
+bool __cdecl ReadEventStamp(HookType hookType, HWND destination, EventStamp* stamp)
+{
+    if (stamp == nullptr)
+        return false;
+
+    EventStampRing* stamps = FindEventStamps(hookType, destination);
+
+    return stamps != nullptr && stamps->TryPop(*stamp);
+}
+
+bool __cdecl GetDroppedEventCount(HookType hookType, int threadId, LONG* droppedEventCount)
+{
+    HookData* hookData = GetHookData(hookType, threadId);
+
+    if (hookData == nullptr || droppedEventCount == nullptr)
+        return false;
+
+    *droppedEventCount = InterlockedCompareExchange(&hookData->DroppedEventCount, 0, 0);
+
+    return true;
 }
 
 LRESULT CALLBACK CallWndProc(int nCode, WPARAM wParam, LPARAM lParam)
 {
     int threadId = static_cast<int>(GetCurrentThreadId());
 
+    if (nCode == HC_ACTION)
+        InvalidateKeyboardState(PointTo<CWPSTRUCT>(lParam)->message);
+
     if (HookData* hookData = GetHookData(CallWindowProcedure, threadId); nCode == HC_ACTION && hookData != nullptr)
     {   
-        HWND destination = hookData->Destination;
-
         auto messageParameters = PointTo<CWPSTRUCT>(lParam);
 
+        HWND destination = SelectDestination(hookData, threadId, messageParameters->hwnd);
+
         if (destination != nullptr)
-            SendHookMessage(destination, messageParameters->message, messageParameters->wParam, messageParameters->lParam);
+        {
+            SendHookMessage(destination,
+                            CallWindowProcedure,
+                            messageParameters->message,
+                            messageParameters->wParam,
+                            messageParameters->lParam);
+        }
     }    
 
     return CallNextHookEx(nullptr, nCode, wParam, lParam);
@@ -160,12 +895,18 @@ LRESULT CALLBACK CallWndProcRet(int nCode, WPARAM wParam, LPARAM lParam)
 
     if (HookData* hookData = GetHookData(CallWindowProcedureReturn, threadId); nCode == HC_ACTION && hookData != nullptr)
     {
-        HWND destination = hookData->Destination;
-        
         auto messageParameters = PointTo<CWPRETSTRUCT>(lParam);
+
+        HWND destination = SelectDestination(hookData, threadId, messageParameters->hwnd);
         
         if (destination != nullptr)
-            SendHookMessage(destination, messageParameters->message, messageParameters->wParam, messageParameters->lParam);
+        {
+            SendHookMessage(destination,
+                            CallWindowProcedureReturn,
+                            messageParameters->message,
+                            messageParameters->wParam,
+                            messageParameters->lParam);
+        }
     }
 
     return CallNextHookEx(nullptr, nCode, wParam, lParam);
@@ -176,37 +917,46 @@ LRESULT CALLBACK GetMsgProc(int nCode, WPARAM wParam, LPARAM lParam)
     int threadId = static_cast<int>(GetCurrentThreadId());    
 
     if (HookData* hookData = GetHookData(GetMessages, threadId); nCode == HC_ACTION && hookData != nullptr)
-    {   
-        if (HWND destination = hookData->Destination; destination != nullptr)
-        {
-            // Unlike some of these other hooks, we are able to modify messages of this hook type
-            // before control is returned to the system.
-            auto messageParameters = PointTo<MSG>(lParam);
+    {
+        bool removed = wParam == PM_REMOVE;
 
-            WaitForSingleObject(SharedSectionMutex, INFINITE);
+        if (PumpData* pumpData = GetPumpData(threadId); pumpData != nullptr)
+            RecordPumpActivity(pumpData, removed);
 
-            __try
-            {
-                ChangeMessage = false;
+        if ((hookData->Options & HeartbeatOnly) == HeartbeatOnly)
+            return CallNextHookEx(nullptr, nCode, wParam, lParam);
 
-                SendHookMessage(
-                    destination, 
-                    messageParameters->message, 
-                    messageParameters->wParam, 
-                    messageParameters->lParam);
+        // Applications spinning on PeekMessage will have this called repeatedly for the same message, so unless
+        // the listener has asked to see them, we only forward messages when they're actually removed from the queue.
+        if (!removed && (hookData->Options & ObservePeeks) != ObservePeeks)
+            return CallNextHookEx(nullptr, nCode, wParam, lParam);
 
-                if (ChangeMessage)
-                {
-                    messageParameters->message = ChangedMessage;
-                    messageParameters->wParam = ChangedWParam;
-                    messageParameters->lParam = ChangedLParam;
-                }
-            }
-            __finally
+        // Unlike some of these other hooks, we are able to modify messages of this hook type
+        // before control is returned to the system.
+        auto messageParameters = PointTo<MSG>(lParam);
+
+        if (HWND destination = SelectDestination(hookData, threadId, messageParameters->hwnd); destination != nullptr)
+        {   // The destination hands back any changes through the hook event's own payload slot, so nothing needs to be held
+            // across the send that could leave other processes waiting on an unresponsive destination.
+            LONG payloadIndex = SendHookMessage(destination,
+                                                GetMessages,
+                                                messageParameters->message,
+                                                messageParameters->wParam,
+                                                messageParameters->lParam,
+                                                removed ? NoEventAttributes : PeekedEvent);
+
+            // Modifying a message that is only being peeked at would have the modification reapplied the next time it's
+            // looked at, so changes are only honored upon removal.
+            UINT changedMessage;
+            HookEventPayload changedPayload;
+
+            if (removed && LoadChangedHookEventPayload(payloadIndex, &changedMessage, &changedPayload))
             {
-                ReleaseMutex(SharedSectionMutex);
+                messageParameters->message = changedMessage;
+                messageParameters->wParam = changedPayload.WParam;
+                messageParameters->lParam = changedPayload.LParam;
             }
-        }        
+        }
     }
 
     return CallNextHookEx(nullptr, nCode, wParam, lParam);
@@ -218,13 +968,28 @@ LRESULT CALLBACK KeyboardProc(int nCode, WPARAM wParam, LPARAM lParam)
 
     if (HookData* hookData = GetHookData(Keyboard, threadId); nCode == HC_ACTION && hookData != nullptr)
     {
-        HWND destination = hookData->Destination;
+        HWND destination = SelectDestination(hookData, threadId, nullptr);
 
         WORD keyFlags = HIWORD(lParam);
         bool isKeyUp = (keyFlags & KF_UP) == KF_UP;
-        
+        bool isExtended = (keyFlags & KF_EXTENDED) == KF_EXTENDED;
+
+        // Reading the tick count doesn't enter the kernel, so checking for a lull in input costs next to nothing.
+        DWORD time = GetTickCount();
+
+        if (KeyboardHookState.NeedsResync() || time - LastKeyboardHookTime > KeyboardResyncInterval)
+            ResyncKeyboardState(KeyboardHookState);
+
+        LastKeyboardHookTime = time;
+
+        KeyboardModifiers modifiers = KeyboardHookState.Update(
+            static_cast<unsigned int>(wParam), isKeyUp, isExtended, LOBYTE(keyFlags));
+
         if (destination != nullptr)
-            SendHookMessage(destination, isKeyUp ? WM_KEYUP : WM_KEYDOWN, wParam, lParam);
+        {
+            SendHookMessage(
+                destination, Keyboard, isKeyUp ? WM_KEYUP : WM_KEYDOWN, PackKeyboardModifiers(wParam, modifiers), lParam);
+        }
     }
 
     return CallNextHookEx(nullptr, nCode, wParam, lParam);
@@ -236,15 +1001,26 @@ LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam)
 
     if (HookData* hookData = GetHookData(LowLevelKeyboard, threadId); nCode == HC_ACTION && hookData != nullptr)
     {
-        HWND destination = hookData->Destination;
+        HWND destination = SelectDestination(hookData, threadId, nullptr);
 
         auto keyboardInput = PointTo<KBDLLHOOKSTRUCT>(lParam);
         auto message = static_cast<unsigned int>(wParam);
 
+        bool isKeyUp = (keyboardInput->flags & LLKHF_UP) == LLKHF_UP;
+        bool isExtended = (keyboardInput->flags & LLKHF_EXTENDED) == LLKHF_EXTENDED;
+
+        KeyboardModifiers modifiers = UpdateKeyboardState(
+            LowLevelKeyboardHookState, keyboardInput->vkCode, isKeyUp, isExtended, keyboardInput->scanCode);
+
         // Low-level keyboard hooks have very stringent execution requirements. To alleviate this burden on
         // our code, we asynchronously post the hook event to our listener.
         if (destination != nullptr)
-            PostHookMessage(destination, message, keyboardInput->vkCode, keyboardInput->flags);
+        {
+            LPARAM parameters = PackLowLevelKeyboardEvent(
+                PackKeyboardModifiers(keyboardInput->vkCode, modifiers), keyboardInput->flags);
+
+            PostInputHookMessage(LowLevelKeyboard, hookData, destination, message, parameters, keyboardInput->time);
+        }
     }
 
     return CallNextHookEx(nullptr, nCode, wParam, lParam);
@@ -256,13 +1032,13 @@ LRESULT CALLBACK MouseProc(int nCode, WPARAM wParam, LPARAM lParam)
 
     if (HookData* hookData = GetHookData(Mouse, threadId); nCode == HC_ACTION && hookData != nullptr)
     {
-        HWND destination = hookData->Destination;
-
         auto mouseInput = PointTo<MOUSEHOOKSTRUCT>(lParam);
         auto message = static_cast<unsigned int>(wParam);
 
+        HWND destination = SelectDestination(hookData, threadId, mouseInput->hwnd);
+
         if (destination != nullptr)
-            SendHookMessage(destination, message, mouseInput->pt.x, mouseInput->pt.y);
+            SendHookMessage(destination, Mouse, message, mouseInput->pt.x, mouseInput->pt.y);
     }
 
     return CallNextHookEx(nullptr, nCode, wParam, lParam);
@@ -274,15 +1050,22 @@ LRESULT CALLBACK LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam)
 
     if (HookData* hookData = GetHookData(LowLevelMouse, threadId); nCode == HC_ACTION && hookData != nullptr)
     {
-        HWND destination = hookData->Destination;
-
         auto mouseInput = PointTo<MSLLHOOKSTRUCT>(lParam);
         auto message = static_cast<unsigned int>(wParam);
 
+        HWND destination = SelectDestination(hookData, threadId, nullptr);
+
         // Low-level keyboard hooks have very stringent execution requirements. To alleviate this burden on
         // our code, we asynchronously post the hook event to our listener.
         if (destination != nullptr)
-            PostHookMessage(destination, message, mouseInput->pt.x, mouseInput->pt.y);
+        {
+            PostInputHookMessage(LowLevelMouse,
+                                 hookData,
+                                 destination,
+                                 message,
+                                 PackLowLevelMouseEvent(mouseInput->pt.x, mouseInput->pt.y),
+                                 mouseInput->time);
+        }
     }
 
     return CallNextHookEx(nullptr, nCode, wParam, lParam);
@@ -0,0 +1,102 @@
+// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "HookTypes.h"
+
+/**
+ * Provides a bounded, lock-free queue of event stamps passed from a hook procedure to a single destination window.
+ * @remarks
+ * Stamps travel alongside the hook messages they describe, with the hook procedure pushing a stamp immediately before
+ * posting its message and the destination popping one for every message it receives. There must only ever be one thread
+ * pushing and one thread popping; low-level hook procedures always run on the thread that installed them, which satisfies
+ * the former.
+ */
+class EventStampRing
+{
+public:
+	/**
+	 * The maximum number of stamps the queue can hold, which must be a power of two.
+	 */
+	static constexpr std::uint32_t Capacity = 4096;
+
+	/**
+	 * Discards all stamps currently in the queue.
+	 * @note This should only be called while no hook procedure is pushing to the queue and no destination is popping from it.
+	 */
+	void Reset()
+	{
+		_head.store(0, std::memory_order_relaxed);
+		_tail.store(0, std::memory_order_release);
+	}
+
+	/**
+	 * Pushes a stamp onto the queue.
+	 * @param stamp The stamp to push.
+	 * @return True if the stamp was pushed; false if the queue is full.
+	 */
+	bool TryPush(const EventStamp& stamp)
+	{
+		std::uint32_t tail = _tail.load(std::memory_order_relaxed);
+
+		if (tail - _head.load(std::memory_order_acquire) == Capacity)
+			return false;
+
+		_stamps[tail & Mask] = stamp;
+		_tail.store(tail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	/**
+	 * Takes back the most recently pushed stamp, whose message could not be posted.
+	 * @remarks
+	 * This is safe to do without coordinating with the destination, as it will never pop more stamps than it has received
+	 * messages for, and the message for this stamp was never sent.
+	 */
+	void Retract()
+	{
+		_tail.store(_tail.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+	}
+
+	/**
+	 * Pops the oldest stamp off of the queue.
+	 * @param stamp The variable that receives the popped stamp.
+	 * @return True if a stamp was popped; false if the queue is empty.
+	 */
+	bool TryPop(EventStamp& stamp)
+	{
+		std::uint32_t head = _head.load(std::memory_order_relaxed);
+
+		if (head == _tail.load(std::memory_order_acquire))
+			return false;
+
+		stamp = _stamps[head & Mask];
+		_head.store(head + 1, std::memory_order_release);
+
+		return true;
+	}
+
+private:
+	static constexpr std::uint32_t Mask = Capacity - 1;
+
+	static_assert((Capacity & Mask) == 0, "The capacity must be a power of two.");
+
+	alignas(64) std::atomic<std::uint32_t> _head { 0 };
+	alignas(64) std::atomic<std::uint32_t> _tail { 0 };
+	EventStamp _stamps[Capacity] {};
+};
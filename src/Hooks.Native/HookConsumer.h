@@ -0,0 +1,822 @@
+// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "HookTypes.h"
+
+#ifdef _WIN32
+#include <future>
+
+#include "Hooks.h"
+#include "RawInputTranslator.h"
+#endif
+
+namespace BadEcho::Hooks
+{
+	/**
+	 * Represents an event received from an installed hook procedure.
+	 * @remarks The meaning of the message parameters depends on the type of hook procedure that generated the event.
+	 */
+	struct HookEvent
+	{
+		/**
+		 * The type of hook procedure that generated the event.
+		 */
+		HookType Type;
+		/**
+		 * The message identifier.
+		 */
+		unsigned int Message;
+		/**
+		 * Additional message-specific information.
+		 */
+		std::uintptr_t WParam;
+		/**
+		 * Additional message-specific information.
+		 */
+		std::intptr_t LParam;
+		/**
+		 * Additional information about the event, such as whether a \c WH_GETMESSAGE message is only being peeked at.
+		 */
+		HookEventAttributes Attributes;
+	};
+
+	/**
+	 * Represents a keyboard input event generated by a \c WH_KEYBOARD or \c WH_KEYBOARD_LL hook procedure.
+	 */
+	struct KeyboardEvent
+	{
+		/**
+		 * The keyboard input message, such as \c WM_KEYDOWN or \c WM_KEYUP.
+		 */
+		unsigned int Message;
+		/**
+		 * The virtual-key code of the key that generated the event.
+		 */
+		unsigned int VirtualKey;
+		/**
+		 * The keystroke flags (for \c WH_KEYBOARD) or low-level input flags (for \c WH_KEYBOARD_LL) of the event.
+		 */
+		unsigned int Flags;
+		/**
+		 * The modifier and toggle key states after the event was applied.
+		 */
+		KeyboardModifiers Modifiers;
+	};
+
+	/**
+	 * Represents a mouse input event generated by a \c WH_MOUSE or \c WH_MOUSE_LL hook procedure.
+	 */
+	struct MouseEvent
+	{
+		/**
+		 * The mouse input message, such as \c WM_MOUSEMOVE or \c WM_LBUTTONDOWN.
+		 */
+		unsigned int Message;
+		/**
+		 * The x-coordinate of the cursor, in screen coordinates.
+		 */
+		int X;
+		/**
+		 * The y-coordinate of the cursor, in screen coordinates.
+		 */
+		int Y;
+	};
+
+	/**
+	 * Interprets a hook event as keyboard input.
+	 * @param hookEvent A hook event generated by a \c WH_KEYBOARD or \c WH_KEYBOARD_LL hook procedure.
+	 * @return The keyboard input described by \c hookEvent.
+	 */
+	inline KeyboardEvent ToKeyboardEvent(const HookEvent& hookEvent)
+	{
+		return KeyboardEvent{
+			hookEvent.Message,
+			static_cast<unsigned int>(hookEvent.WParam & 0xFFFF),
+			static_cast<unsigned int>(hookEvent.LParam),
+			static_cast<KeyboardModifiers>((hookEvent.WParam >> KeyboardModifiersShift) & 0xFF)
+		};
+	}
+
+	/**
+	 * Interprets a hook event as mouse input.
+	 * @param hookEvent A hook event generated by a \c WH_MOUSE or \c WH_MOUSE_LL hook procedure.
+	 * @return The mouse input described by \c hookEvent.
+	 */
+	inline MouseEvent ToMouseEvent(const HookEvent& hookEvent)
+	{
+		return MouseEvent{
+			hookEvent.Message,
+			static_cast<int>(hookEvent.WParam),
+			static_cast<int>(hookEvent.LParam)
+		};
+	}
+
+	/**
+	 * Provides a coroutine for consuming hook events that runs on a thread of its own, whose completion can be waited upon.
+	 * @remarks
+	 * The coroutine is started on its thread as soon as it is created, and is resumed there every time one of its reads
+	 * from a \c HookEventChannel completes. Publishers therefore never run any of the consumer's code; they merely signal
+	 * the consumer's thread, which picks up everything published in the meantime once it gets around to reading again.
+	 */
+	class ConsumerTask
+	{
+	public:
+		struct promise_type
+		{
+			std::atomic<bool> Completed = false;
+			std::exception_ptr Exception;
+
+			ConsumerTask get_return_object()
+			{
+				return ConsumerTask(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+
+			auto initial_suspend() noexcept
+			{	// The coroutine is only resumed by its thread once it has been fully suspended.
+				struct StartAwaiter
+				{
+					bool await_ready() noexcept { return false; }
+
+					void await_suspend(std::coroutine_handle<promise_type> task)
+					{
+						task.promise()._thread = std::thread([task] { task.promise().Run(task); });
+					}
+
+					void await_resume() noexcept { }
+				};
+
+				return StartAwaiter{};
+			}
+
+			auto final_suspend() noexcept
+			{	// Completion is only signaled once the coroutine is actually suspended, so the waiter is free to destroy it.
+				struct CompletionAwaiter
+				{
+					bool await_ready() noexcept { return false; }
+
+					void await_suspend(std::coroutine_handle<promise_type> task) noexcept
+					{
+						task.promise().Completed.store(true);
+						task.promise().Completed.notify_all();
+					}
+
+					void await_resume() noexcept { }
+				};
+
+				return CompletionAwaiter{};
+			}
+
+			void return_void() noexcept
+			{ }
+
+			void unhandled_exception() noexcept
+			{
+				Exception = std::current_exception();
+			}
+
+			/**
+			 * Schedules a suspended coroutine to be resumed on the task's thread.
+			 * @param continuation The coroutine to resume, which must belong to the task.
+			 * @remarks This only signals the task's thread, and so is safe to call from any thread without blocking.
+			 */
+			void Schedule(std::coroutine_handle<> continuation)
+			{	// The signal is raised while holding the lock, which the task's thread must acquire before it can resume the
+				// coroutine and potentially complete it, so the promise can't be destroyed out from under us.
+				std::scoped_lock lock(_scheduleMutex);
+
+				_scheduled = continuation;
+				_scheduleSignal.notify_one();
+			}
+
+		private:
+			friend class ConsumerTask;
+
+			void Run(std::coroutine_handle<promise_type> task)
+			{
+				std::coroutine_handle<> next = task;
+
+				while (true)
+				{
+					next.resume();
+
+					if (task.done())
+						return;
+
+					std::unique_lock lock(_scheduleMutex);
+
+					_scheduleSignal.wait(lock, [this] { return static_cast<bool>(_scheduled); });
+					next = std::exchange(_scheduled, nullptr);
+				}
+			}
+
+			std::mutex _scheduleMutex;
+			std::condition_variable _scheduleSignal;
+			std::coroutine_handle<> _scheduled;
+			std::thread _thread;
+		};
+
+		ConsumerTask(ConsumerTask&& other) noexcept
+			: _task(std::exchange(other._task, nullptr))
+		{ }
+
+		ConsumerTask(const ConsumerTask&) = delete;
+		ConsumerTask& operator=(const ConsumerTask&) = delete;
+		ConsumerTask& operator=(ConsumerTask&&) = delete;
+
+		~ConsumerTask()
+		{
+			if (!_task)
+				return;
+
+			_task.promise().Completed.wait(false);
+			_task.promise()._thread.join();
+			_task.destroy();
+		}
+
+		/**
+		 * Blocks the calling thread until the task has completed.
+		 * @remarks Any exception thrown by the task is rethrown here.
+		 */
+		void Wait()
+		{
+			_task.promise().Completed.wait(false);
+
+			if (_task.promise().Exception)
+				std::rethrow_exception(_task.promise().Exception);
+		}
+
+		/**
+		 * Gets a value indicating if the task has completed.
+		 * @return True if the task has completed; otherwise, false.
+		 */
+		bool IsCompleted() const
+		{
+			return _task.promise().Completed.load();
+		}
+
+	private:
+		explicit ConsumerTask(std::coroutine_handle<promise_type> task)
+			: _task(task)
+		{ }
+
+		std::coroutine_handle<promise_type> _task;
+	};
+
+	class HookEventChannel;
+
+	/**
+	 * Provides an awaitable read of a batch of hook events from a channel.
+	 * @remarks
+	 * Awaiting this yields all events available in the channel at the time of resumption, up to the requested maximum.
+	 * An empty batch is only ever yielded when the channel has been closed or the read has been cancelled. Reads can only be
+	 * awaited from a \c ConsumerTask coroutine, which is always resumed on its own thread.
+	 */
+	class ReadBatchAwaitable
+	{
+	public:
+		/**
+		 * Initializes a new instance of the \c ReadBatchAwaitable class.
+		 * @param channel The channel to read hook events from.
+		 * @param maxCount The maximum number of hook events to read.
+		 * @param stopToken A token that can be used to cancel the read.
+		 */
+		ReadBatchAwaitable(HookEventChannel& channel, std::size_t maxCount, std::stop_token stopToken)
+			: _channel(channel), _maxCount(maxCount), _stopToken(std::move(stopToken))
+		{ }
+
+		ReadBatchAwaitable(const ReadBatchAwaitable&) = delete;
+		ReadBatchAwaitable& operator=(const ReadBatchAwaitable&) = delete;
+
+		bool await_ready();
+		bool await_suspend(std::coroutine_handle<ConsumerTask::promise_type> awaiter);
+		std::vector<HookEvent> await_resume();
+
+	private:
+		struct Canceller
+		{
+			ReadBatchAwaitable* Read;
+
+			void operator()() const noexcept;
+		};
+
+		friend class HookEventChannel;
+
+		void Wake()
+		{
+			_consumer.promise().Schedule(_consumer);
+		}
+
+		HookEventChannel& _channel;
+		std::size_t _maxCount;
+		std::stop_token _stopToken;
+		std::vector<HookEvent> _batch;
+		std::optional<std::stop_callback<Canceller>> _stopCallback;
+		std::coroutine_handle<ConsumerTask::promise_type> _consumer;
+		bool _cancelled = false;
+	};
+
+	/**
+	 * Provides a bounded, thread-safe queue of hook events that a single consumer can read from asynchronously.
+	 * @remarks
+	 * Publishing never blocks, nor does it ever run the consumer. Hook events are usually published from the thread handling
+	 * messages sent by hook procedures, and blocking there would in turn block the hooked applications waiting on those
+	 * sends. A waiting consumer is only signaled, so that it reads everything published by the time its thread resumes it
+	 * in one batch. Events published to a full channel are dropped, and counted as such, instead.
+	 */
+	class HookEventChannel
+	{
+	public:
+		/**
+		 * The default maximum number of hook events a channel will hold before it starts dropping them.
+		 */
+		static constexpr std::size_t DefaultCapacity = 4096;
+
+		/**
+		 * Initializes a new instance of the \c HookEventChannel class.
+		 * @param capacity The maximum number of hook events the channel will hold before it starts dropping them.
+		 */
+		explicit HookEventChannel(std::size_t capacity = DefaultCapacity)
+			: _capacity(capacity)
+		{ }
+
+		HookEventChannel(const HookEventChannel&) = delete;
+		HookEventChannel& operator=(const HookEventChannel&) = delete;
+
+		/**
+		 * Adds a hook event to the channel.
+		 * @param hookEvent The hook event to add.
+		 * @return True if the hook event was added; false if the channel is closed or full.
+		 */
+		bool Publish(const HookEvent& hookEvent)
+		{
+			return Publish(std::span(&hookEvent, 1)) == 1;
+		}
+
+		/**
+		 * Adds a batch of hook events to the channel.
+		 * @param hookEvents The hook events to add.
+		 * @return The number of hook events that were added, which will be less than the number provided if the channel
+		 * is closed or does not have enough room for all of them.
+		 */
+		std::size_t Publish(std::span<const HookEvent> hookEvents)
+		{
+			ReadBatchAwaitable* waitingRead = nullptr;
+			std::size_t published;
+
+			{
+				std::scoped_lock lock(_mutex);
+
+				if (_closed)
+					return 0;
+
+				published = (std::min)(hookEvents.size(), _capacity - _events.size());
+				_events.insert(_events.end(), hookEvents.begin(), hookEvents.begin() + static_cast<std::ptrdiff_t>(published));
+
+				if (published > 0)
+					waitingRead = std::exchange(_waitingRead, nullptr);
+			}
+
+			if (published < hookEvents.size())
+				_droppedCount.fetch_add(hookEvents.size() - published, std::memory_order_relaxed);
+
+			if (waitingRead != nullptr)
+				waitingRead->Wake();
+
+			return published;
+		}
+
+		/**
+		 * Closes the channel, preventing any more hook events from being added to it.
+		 * @remarks Hook events already in the channel can still be read after it is closed.
+		 */
+		void Close()
+		{
+			ReadBatchAwaitable* waitingRead;
+
+			{
+				std::scoped_lock lock(_mutex);
+
+				_closed = true;
+				waitingRead = std::exchange(_waitingRead, nullptr);
+			}
+
+			if (waitingRead != nullptr)
+				waitingRead->Wake();
+		}
+
+		/**
+		 * Gets a value indicating if the channel has been closed.
+		 * @return True if the channel has been closed; otherwise, false.
+		 */
+		bool IsClosed() const
+		{
+			std::scoped_lock lock(_mutex);
+
+			return _closed;
+		}
+
+		/**
+		 * Gets the number of hook events dropped because the channel was full.
+		 * @return The number of hook events dropped because the channel was full.
+		 */
+		std::uint64_t DroppedCount() const
+		{
+			return _droppedCount.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * Reads all currently available hook events from the channel without waiting, up to a maximum.
+		 * @param batch The vector to append the hook events to.
+		 * @param maxCount The maximum number of hook events to read.
+		 * @return The number of hook events read.
+		 */
+		std::size_t TryReadBatch(std::vector<HookEvent>& batch, std::size_t maxCount)
+		{
+			std::scoped_lock lock(_mutex);
+
+			std::size_t count = (std::min)(maxCount, _events.size());
+			auto end = _events.begin() + static_cast<std::ptrdiff_t>(count);
+
+			batch.insert(batch.end(), _events.begin(), end);
+			_events.erase(_events.begin(), end);
+
+			return count;
+		}
+
+		/**
+		 * Reads a batch of hook events from the channel, waiting for them to become available if need be.
+		 * @param maxCount The maximum number of hook events to read.
+		 * @param stopToken A token that can be used to cancel the read.
+		 * @return An awaitable that yields the batch of hook events read, which will be empty if the channel was closed or
+		 * the read was cancelled.
+		 * @remarks Only a single read may be outstanding at any one time. A read that has to wait is resumed on the thread
+		 * of the \c ConsumerTask awaiting it, regardless of the thread that published the hook events, closed the channel,
+		 * or requested cancellation.
+		 */
+		ReadBatchAwaitable ReadBatchAsync(std::size_t maxCount, std::stop_token stopToken = {})
+		{
+			return ReadBatchAwaitable(*this, maxCount, std::move(stopToken));
+		}
+
+	private:
+		friend class ReadBatchAwaitable;
+
+		bool SuspendReader(ReadBatchAwaitable* read)
+		{
+			std::scoped_lock lock(_mutex);
+
+			if (!_events.empty() || _closed || read->_cancelled)
+				return false;
+
+			_waitingRead = read;
+
+			return true;
+		}
+
+		void CancelReader(ReadBatchAwaitable* read)
+		{
+			bool wasWaiting;
+
+			{
+				std::scoped_lock lock(_mutex);
+
+				read->_cancelled = true;
+				wasWaiting = _waitingRead == read;
+
+				if (wasWaiting)
+					_waitingRead = nullptr;
+			}
+
+			if (wasWaiting)
+				read->Wake();
+		}
+
+		mutable std::mutex _mutex;
+		std::deque<HookEvent> _events;
+		std::size_t _capacity;
+		bool _closed = false;
+		std::atomic<std::uint64_t> _droppedCount = 0;
+		ReadBatchAwaitable* _waitingRead = nullptr;
+	};
+
+	inline bool ReadBatchAwaitable::await_ready()
+	{
+		if (_stopToken.stop_requested())
+		{
+			_cancelled = true;
+			return true;
+		}
+
+		return _channel.TryReadBatch(_batch, _maxCount) > 0 || _channel.IsClosed();
+	}
+
+	inline bool ReadBatchAwaitable::await_suspend(std::coroutine_handle<ConsumerTask::promise_type> awaiter)
+	{	// The stop callback is registered before the reader is made visible to the channel. Should a stop already have been
+		// requested, the callback runs right here and merely flags the read as cancelled, as there's nothing to wake yet.
+		_consumer = awaiter;
+		_stopCallback.emplace(_stopToken, Canceller{ this });
+
+		return _channel.SuspendReader(this);
+	}
+
+	inline std::vector<HookEvent> ReadBatchAwaitable::await_resume()
+	{
+		if (_batch.empty() && !_cancelled)
+			_channel.TryReadBatch(_batch, _maxCount);
+
+		return std::move(_batch);
+	}
+
+	inline void ReadBatchAwaitable::Canceller::operator()() const noexcept
+	{
+		Read->_channel.CancelReader(Read);
+	}
+
+#ifdef _WIN32
+	/**
+	 * Provides a subscription to the events of an installed hook procedure, published to a channel for native consumption.
+	 * @remarks
+	 * <para>
+	 * The subscription runs its own thread with a message-only window that serves as the hook procedure's destination. All
+	 * messages that arrive during a single wake of that thread are published to the channel as one batch.
+	 * </para>
+	 * <para>
+	 * Events are strictly observed; native consumers cannot change the details of messages intercepted by a
+	 * \c WH_GETMESSAGE hook procedure.
+	 * </para>
+	 * <para>
+	 * Low-level keyboard and mouse events can be captured with raw input instead of a hook procedure, in which case the
+	 * window is registered for raw input and the events published are identical to what the hook procedure would send.
+	 * </para>
+	 */
+	class HookSubscription
+	{
+	public:
+		/**
+		 * The maximum number of hook events published to the channel in a single batch.
+		 */
+		static constexpr std::size_t MaxBatchSize = 256;
+
+		/**
+		 * Initializes a new instance of the \c HookSubscription class.
+		 * @param hookType The type of hook procedure to install.
+		 * @param threadId The identifier of the thread with which the hook procedure is to be associated, or 0 for a global
+		 * hook procedure.
+		 * @param options Options that alter the behavior of the hook procedure.
+		 * @param capacity The maximum number of hook events the channel will hold before it starts dropping them.
+		 * @param captureMode
+		 * The mechanism used to capture input events, which can only be \c CaptureWithRawInput for global
+		 * \c LowLevelKeyboard and \c LowLevelMouse subscriptions.
+		 */
+		explicit HookSubscription(HookType hookType,
+		                          int threadId = 0,
+		                          HookOptions options = NoOptions,
+		                          std::size_t capacity = HookEventChannel::DefaultCapacity,
+		                          InputCaptureMode captureMode = CaptureWithHook)
+			: _hookType(hookType), _threadId(threadId), _options(options), _captureMode(captureMode), _events(capacity)
+		{ }
+
+		HookSubscription(const HookSubscription&) = delete;
+		HookSubscription& operator=(const HookSubscription&) = delete;
+
+		~HookSubscription()
+		{
+			Stop();
+		}
+
+		/**
+		 * Starts the subscription's message loop and installs the hook procedure.
+		 * @return True if the hook procedure was installed; otherwise, false.
+		 */
+		bool Start()
+		{
+			if (_thread.joinable())
+				return true;
+
+			std::promise<bool> started;
+			std::future<bool> result = started.get_future();
+
+			_thread = std::jthread([this, &started] { Run(started); });
+
+			if (result.get())
+				return true;
+
+			_thread.join();
+
+			return false;
+		}
+
+		/**
+		 * Uninstalls the hook procedure, shuts down the subscription's message loop, and closes its channel.
+		 */
+		void Stop()
+		{
+			if (!_thread.joinable())
+				return;
+
+			PostThreadMessageW(_loopThreadId, WM_QUIT, 0, 0);
+			_thread.join();
+		}
+
+		/**
+		 * Gets the channel that hook events are published to.
+		 * @return The channel that hook events are published to.
+		 */
+		HookEventChannel& Events()
+		{
+			return _events;
+		}
+
+	private:
+		static constexpr const wchar_t* WindowClassName = L"BadEcho.Hooks.HookSubscription";
+		static constexpr int RawInputCapacity = 256;
+
+		static LRESULT CALLBACK WindowProcedure(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+		{
+			auto subscription = reinterpret_cast<HookSubscription*>(GetWindowLongPtrW(hWnd, GWLP_USERDATA));
+
+			if (message == WM_INPUT && subscription != nullptr)
+			{	// The system still needs to clean up after raw input messages, even though we read their data in bulk.
+				subscription->DrainRawInput(reinterpret_cast<HRAWINPUT>(lParam));
+
+				return DefWindowProcW(hWnd, message, wParam, lParam);
+			}
+
+			if (message != GetHookEventMessage())
+				return DefWindowProcW(hWnd, message, wParam, lParam);
+
+			HookEventPayload payload;
+
+			// The header tells us everything about the event but its parameters, which are only lost if thousands of other
+			// hook procedures were waiting on their destinations while this one was being sent.
+			if (subscription != nullptr && ReadHookEventPayload(wParam, lParam, &payload))
+			{
+				subscription->_pending.push_back(
+					HookEvent{ static_cast<HookType>(wParam & 0xFF),
+					           static_cast<unsigned int>(wParam >> HookEventMessageShift) & 0xFFFF,
+					           payload.WParam,
+					           payload.LParam,
+					           static_cast<HookEventAttributes>((wParam >> HookEventAttributesShift) & 0xFF) });
+			}
+
+			return 0;
+		}
+
+		void Run(std::promise<bool>& started)
+		{
+			HINSTANCE instance = GetModuleHandleW(nullptr);
+
+			WNDCLASSEXW windowClass{};
+			windowClass.cbSize = sizeof(WNDCLASSEXW);
+			windowClass.lpfnWndProc = WindowProcedure;
+			windowClass.hInstance = instance;
+			windowClass.lpszClassName = WindowClassName;
+
+			// Registration fails harmlessly when another subscription has already registered the class.
+			RegisterClassExW(&windowClass);
+
+			HWND window = CreateWindowExW(
+				0, WindowClassName, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, instance, nullptr);
+
+			if (window == nullptr)
+			{
+				_events.Close();
+				started.set_value(false);
+				return;
+			}
+
+			SetWindowLongPtrW(window, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
+
+			_loopThreadId = GetCurrentThreadId();
+			_pending.reserve(MaxBatchSize);
+
+			// Global hook procedures for some hook types are called in the context of the installing thread, so the
+			// hook must be installed from this thread, which is pumping messages. Raw input, likewise, is only delivered
+			// to the thread owning the registered window.
+			if (!Subscribe(window))
+			{
+				DestroyWindow(window);
+				_events.Close();
+				started.set_value(false);
+				return;
+			}
+
+			started.set_value(true);
+
+			PumpMessages();
+
+			Unsubscribe();
+			DestroyWindow(window);
+			Publish();
+			_events.Close();
+		}
+
+		bool Subscribe(HWND window)
+		{
+			if (_captureMode == CaptureWithRawInput)
+				return _threadId == 0 && RegisterRawInput(_hookType, window);
+
+			return AddHook(_hookType, window, _threadId, _options);
+		}
+
+		void Unsubscribe()
+		{
+			if (_captureMode == CaptureWithRawInput)
+				UnregisterRawInput(_hookType);
+			else
+				RemoveHook(_hookType, _threadId);
+		}
+
+		void DrainRawInput(HRAWINPUT input)
+		{
+			InputEvent inputEvents[RawInputCapacity];
+			int count;
+
+			// A read that comes close to filling the array may have left raw input behind for the next read.
+			do
+			{
+				count = ReadRawInput(input, inputEvents, RawInputCapacity);
+
+				for (int i = 0; i < count; i++)
+				{
+					_pending.push_back(
+						HookEvent{ _hookType,
+						           inputEvents[i].Message,
+						           inputEvents[i].WParam,
+						           inputEvents[i].LParam,
+						           NoEventAttributes });
+				}
+
+				input = nullptr;
+			} while (count > RawInputCapacity - static_cast<int>(RawInputTranslator::MaxEventsPerInput));
+		}
+
+		void PumpMessages()
+		{
+			MSG message;
+
+			while (true)
+			{	// Unlike GetMessage, this wakes us up for messages sent by hook procedures, which PeekMessage then dispatches
+				// to our window procedure directly, in addition to messages posted by them.
+				MsgWaitForMultipleObjectsEx(0, nullptr, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+
+				while (_pending.size() < MaxBatchSize && PeekMessageW(&message, nullptr, 0, 0, PM_REMOVE))
+				{
+					if (message.message == WM_QUIT)
+						return;
+
+					DispatchMessageW(&message);
+				}
+
+				Publish();
+			}
+		}
+
+		void Publish()
+		{
+			if (_pending.empty())
+				return;
+
+			_events.Publish(_pending);
+			_pending.clear();
+		}
+
+		HookType _hookType;
+		int _threadId;
+		HookOptions _options;
+		InputCaptureMode _captureMode;
+		HookEventChannel _events;
+		std::vector<HookEvent> _pending;
+		DWORD _loopThreadId = 0;
+		std::jthread _thread;
+	};
+#endif
+}
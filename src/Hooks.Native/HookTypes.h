@@ -0,0 +1,270 @@
+// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2025 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Specifies a type of hook procedure.
+ */
+enum HookType : unsigned char
+{
+	/**
+	 * Monitors \c WH_CALLWNDPROC messages before the system sends them to the destination window
+	 * procedure.
+	 */
+	CallWindowProcedure,
+	/**
+	 * Monitors \c WH_CALLWNDPROCRET messages after they have been processed by the destination
+	 * window procedure.
+	 */
+	CallWindowProcedureReturn,
+	/**
+	 * Monitors \c WH_GETMESSAGE messages posted to a message queue prior to their retrieval.
+	 * @remarks This is named \c GetMessages to avoid conflicting with the ever-present \c GetMessage Win32 macro.
+	 */
+	GetMessages,
+	/**
+	 * Monitors \c WH_KEYBOARD keystroke messages.
+	 */
+	Keyboard,
+	/**
+	 * Monitors \c WH_KEYBOARD_LL low-level keyboard input events.
+	 */
+	LowLevelKeyboard,
+	/**
+	 * Monitors \c WH_MOUSE mouse messages.
+	 */
+	Mouse,
+	/**
+	 * Monitors \c WH_MOUSE_LL low-level mouse input events.
+	 */
+	LowLevelMouse
+};
+
+/**
+ * Specifies options that alter the behavior of an installed hook procedure.
+ */
+enum HookOptions : unsigned char
+{
+	/**
+	 * The hook procedure forwards all hook events to its destination window.
+	 */
+	NoOptions = 0x0,
+	/**
+	 * The \c WH_GETMESSAGE hook procedure only records message pump activity for the hooked thread, forwarding
+	 * nothing to its destination window.
+	 */
+	HeartbeatOnly = 0x1,
+	/**
+	 * The \c WH_GETMESSAGE hook procedure forwards messages that are only being examined by \c PeekMessage with
+	 * \c PM_NOREMOVE, in addition to messages being removed from the queue.
+	 */
+	ObservePeeks = 0x2,
+	/**
+	 * The \c WH_KEYBOARD_LL and \c WH_MOUSE_LL hook procedures stamp every event they forward with its sequence number
+	 * and capture time, which the listener reads back with \c ReadEventStamp.
+	 */
+	TraceEvents = 0x4
+};
+
+/**
+ * Specifies how hook events are distributed across multiple destination windows.
+ */
+enum ShardingPolicy : unsigned char
+{
+	/**
+	 * Events are distributed by the identifier of the thread that generated them, preserving the order of events
+	 * from any one thread.
+	 */
+	ShardByThread,
+	/**
+	 * Events are distributed by the window they are associated with, preserving the order of events for any one window.
+	 * Events with no associated window are all sent to the first destination.
+	 */
+	ShardByWindow,
+	/**
+	 * Events are distributed evenly across all destinations with no regard to their order, which is suitable only for
+	 * stateless handlers.
+	 */
+	ShardRoundRobin
+};
+
+/**
+ * The maximum number of destination windows a single hook procedure can distribute its events across.
+ */
+constexpr int MaxDestinations = 8;
+
+/**
+ * Specifies a change to make to the set of installed hook procedures.
+ */
+enum HookChangeAction : unsigned char
+{
+	/**
+	 * A hook procedure is installed into a thread.
+	 */
+	InstallHook,
+	/**
+	 * A hook procedure is uninstalled from a thread.
+	 */
+	UninstallHook
+};
+
+/**
+ * Specifies the modifier and toggle key states reported alongside keyboard hook events.
+ * @remarks The modifier flags share their values with \c MOD_ALT, \c MOD_CONTROL, \c MOD_SHIFT, and \c MOD_WIN.
+ */
+enum KeyboardModifiers : unsigned char
+{
+	/**
+	 * No modifier keys are held and no toggle keys are on.
+	 */
+	NoModifiers = 0x0,
+	/**
+	 * Either ALT key is held.
+	 */
+	AltModifier = 0x1,
+	/**
+	 * Either CTRL key is held.
+	 */
+	ControlModifier = 0x2,
+	/**
+	 * Either SHIFT key is held.
+	 */
+	ShiftModifier = 0x4,
+	/**
+	 * Either Windows logo key is held.
+	 */
+	WindowsModifier = 0x8,
+	/**
+	 * CAPS LOCK is on.
+	 */
+	CapsLockToggled = 0x10,
+	/**
+	 * NUM LOCK is on.
+	 */
+	NumLockToggled = 0x20,
+	/**
+	 * SCROLL LOCK is on.
+	 */
+	ScrollLockToggled = 0x40
+};
+
+/**
+ * The number of bits the modifier and toggle key states are shifted by when packed alongside the virtual-key code in the
+ * \c wParam of a keyboard hook message.
+ */
+constexpr int KeyboardModifiersShift = 16;
+
+
+/**
+ * The number of bits the intercepted message identifier is shifted by when packed above the hook type in the header
+ * carried by the \c wParam of a hook event message.
+ */
+constexpr int HookEventMessageShift = 8;
+
+/**
+ * Specifies additional information about a hook event, carried in its header.
+ */
+enum HookEventAttributes : unsigned char
+{
+	/**
+	 * The hook event has no additional information.
+	 */
+	NoEventAttributes = 0x0,
+	/**
+	 * The message queue message is only being examined by \c PeekMessage with \c PM_NOREMOVE, rather than being removed
+	 * from the queue, and so its details cannot be changed.
+	 */
+	PeekedEvent = 0x1
+};
+
+/**
+ * The number of bits the hook event attributes are shifted by when packed above the intercepted message identifier in the
+ * header carried by the \c wParam of a hook event message.
+ */
+constexpr int HookEventAttributesShift = 24;
+
+/**
+ * Represents the message parameters of a hook event, which travel either through shared memory or, for low-level hook
+ * events, packed into the hook event message alongside its header.
+ */
+struct HookEventPayload
+{
+	/**
+	 * Additional message-specific information.
+	 */
+	std::uintptr_t WParam;
+	/**
+	 * Additional message-specific information.
+	 */
+	std::intptr_t LParam;
+};
+
+/**
+ * Specifies the mechanism used to capture input events for the low-level keyboard and mouse hook types.
+ */
+enum InputCaptureMode : unsigned char
+{
+	/**
+	 * Input events are captured by a \c WH_KEYBOARD_LL or \c WH_MOUSE_LL hook procedure, which the system calls
+	 * synchronously as part of its input processing.
+	 */
+	CaptureWithHook,
+	/**
+	 * Input events are captured by registering for raw input, which the system delivers asynchronously to the listener's
+	 * message queue where it can be read in bulk.
+	 */
+	CaptureWithRawInput
+};
+
+/**
+ * Represents an input event in the same form that a low-level input hook procedure sends it to its listener.
+ */
+struct InputEvent
+{
+	/**
+	 * The input message, such as \c WM_KEYDOWN or \c WM_MOUSEMOVE.
+	 */
+	unsigned int Message;
+	/**
+	 * Additional message-specific information.
+	 */
+	std::uintptr_t WParam;
+	/**
+	 * Additional message-specific information.
+	 */
+	std::intptr_t LParam;
+};
+
+/**
+ * Represents the tracing details of an event forwarded by a low-level input hook procedure.
+ */
+struct EventStamp
+{
+	/**
+	 * The event's sequence number, which increases by one with every event the hook procedure captures, including those
+	 * it then fails to deliver.
+	 */
+	std::int32_t Sequence;
+	/**
+	 * The time stamp, in milliseconds, the system assigned to the input, as found in \c KBDLLHOOKSTRUCT and
+	 * \c MSLLHOOKSTRUCT.
+	 */
+	std::uint32_t Time;
+	/**
+	 * The performance counter value at the time the hook procedure captured the event.
+	 */
+	std::int64_t CaptureTime;
+};
\ No newline at end of file
@@ -16,54 +16,118 @@
 
 #include <windows.h>
 
+#include "HookTypes.h"
+
+/**
+ * Represents message pump activity recorded for a thread by its \c WH_GETMESSAGE hook procedure.
+ * @remarks All times are performance counter values, which are consistent across all processes on the system.
+ */
+struct PumpData
+{
+	/**
+	 * The time at which the thread last retrieved a message from its queue.
+	 */
+	LONGLONG LastPumpTime;
+	/**
+	 * The time at which the thread was last probed for responsiveness.
+	 */
+	LONGLONG LastProbeTime;
+	/**
+	 * The time at which the thread first retrieved a message after it was last probed.
+	 */
+	LONGLONG ProbeResponseTime;
+	/**
+	 * The number of messages removed from the thread's queue.
+	 */
+	LONG RetrievalCount;
+	/**
+	 * The number of times a message was examined, but not removed, from the thread's queue.
+	 */
+	LONG PeekCount;
+};
+
 /**
- * Specifies a type of hook procedure.
+ * Represents the contention for the mutex guarding the shared hook registry, accumulated across all processes.
+ * @remarks Only waits on the mutex while it was held by another thread are counted; acquiring it uncontended is free.
  */
-enum HookType : unsigned char
-{	
+struct RegistryContention
+{
+	/**
+	 * The number of times the mutex had to be waited on.
+	 */
+	LONGLONG WaitCount;
 	/**
-	 * Monitors \c WH_CALLWNDPROC messages before the system sends them to the destination window
-	 * procedure.
+	 * The total time spent waiting on the mutex, in performance counter ticks.
 	 */
-	CallWindowProcedure,
+	LONGLONG WaitTicks;
+};
+
+/**
+ * Represents a single hook procedure installation or uninstallation within a batch of changes.
+ */
+struct HookChange
+{
 	/**
-	 * Monitors \c WH_CALLWNDPROCRET messages after they have been processed by the destination
-	 * window procedure.
+	 * The type of hook procedure to change.
 	 */
-	CallWindowProcedureReturn,
+	HookType Type;
 	/**
-	 * Monitors \c WH_GETMESSAGE messages posted to a message queue prior to their retrieval.
-	 * @remarks This is named \c GetMessages to avoid conflicting with the ever-present \c GetMessage Win32 macro.
+	 * The change to make to the hook procedure.
 	 */
-	GetMessages,
+	HookChangeAction Action;
 	/**
-	 * Monitors \c WH_KEYBOARD keystroke messages.
+	 * Options that alter the behavior of the hook procedure, if it is being installed.
 	 */
-	Keyboard,
+	HookOptions Options;
 	/**
-	 * Monitors \c WH_KEYBOARD_LL low-level keyboard input events.
+	 * Value indicating if the change was applied.
 	 */
-	LowLevelKeyboard,
+	bool Succeeded;
 	/**
-	 * Monitors \c WH_MOUSE mouse messages.
+	 * The identifier of the thread the hook procedure is associated with.
 	 */
-	Mouse,
+	int ThreadId;
 	/**
-	 * Monitors \c WH_MOUSE_LL low-level mouse input events.
+	 * A handle to the window that will receive messages sent to the hook procedure, if it is being installed.
 	 */
-	LowLevelMouse
+	HWND Destination;
 };
 
+#ifdef HOOKS_EXPORTS
 #define HOOKS_API extern "C" __declspec(dllexport)
+#else
+#define HOOKS_API extern "C" __declspec(dllimport)
+#endif
 
 /**
  * Installs a new Win32 hook procedure into the specified thread.
  * @param hookType The type of hook procedure to install.
  * @param destination A handle to the window that will receive messages sent to the hook procedure.
  * @param threadId The identifier of the thread with which the hook procedure is to be associated.
+ * @param options Options that alter the behavior of the hook procedure.
+ * @return True if successful; otherwise, false.
+ */
+HOOKS_API bool __cdecl AddHook(HookType hookType, HWND destination, int threadId, HookOptions options);
+
+/**
+ * Installs a new Win32 hook procedure into the specified thread, distributing its events across several windows.
+ * @param hookType The type of hook procedure to install.
+ * @param destinations An array of handles to the windows that will receive messages sent to the hook procedure.
+ * @param destinationCount The number of handles in \c destinations, which may not exceed \c MaxDestinations.
+ * @param policy The policy that determines which destination window a particular hook event is sent to.
+ * @param threadId The identifier of the thread with which the hook procedure is to be associated.
+ * @param options Options that alter the behavior of the hook procedure.
  * @return True if successful; otherwise, false.
+ * @remarks
+ * Spreading events across destination windows owned by separate threads allows a listener to process them on multiple
+ * cores. Ordering is only guaranteed between events sharing the same key under the chosen \c policy.
  */
-HOOKS_API bool __cdecl AddHook(HookType hookType, HWND destination, int threadId);
+HOOKS_API bool __cdecl AddShardedHook(HookType hookType,
+                                      const HWND* destinations,
+                                      int destinationCount,
+                                      ShardingPolicy policy,
+                                      int threadId,
+                                      HookOptions options);
 
 /**
  * Uninstalls a Win32 hook procedure from the specified thread.
@@ -73,6 +137,55 @@ HOOKS_API bool __cdecl AddHook(HookType hookType, HWND destination, int threadId
  */
 HOOKS_API bool __cdecl RemoveHook(HookType hookType, int threadId);
 
+/**
+ * Applies a batch of Win32 hook procedure installations and uninstallations as a single transaction.
+ * @param changes An array of the changes to apply, each of which has its \c Succeeded member set to indicate if it was applied.
+ * @param changeCount The number of changes in \c changes.
+ * @param owner A token identifying the owner of the hook procedures being installed, for later use with \c RemoveOwnedHooks.
+ * @return True if every change was applied; otherwise, false.
+ * @remarks
+ * Shared hook data is updated once to reserve space for the entire batch, and once more to commit it, rather than once for each
+ * change. A batch that can't be reserved, or has any installation fail, is abandoned with no hook procedures changed. A hook
+ * procedure can be reconfigured by uninstalling and reinstalling it in the same batch. Uninstallations are applied only after
+ * every installation has succeeded, and any that then fail are simply reported as such.
+ */
+HOOKS_API bool __cdecl ApplyHookChanges(HookChange* changes, int changeCount, int owner);
+
+/**
+ * Uninstalls every Win32 hook procedure installed by the calling process on behalf of the specified owner.
+ * @param owner
+ * The token identifying the owner of the hook procedures, which is zero for those installed with \c AddHook or
+ * \c AddShardedHook.
+ * @return The number of hook procedures uninstalled.
+ */
+HOOKS_API int __cdecl RemoveOwnedHooks(int owner);
+
+/**
+ * Retrieves the identifier of the registered message that hook procedures send their events to destination windows with.
+ * @return The identifier of the hook event message, or zero if it could not be registered.
+ * @remarks
+ * The message's \c wParam is a header with the type of hook procedure that sent it in its low byte, the intercepted message
+ * identifier in the 16 bits starting at \c HookEventMessageShift, and the event's \c HookEventAttributes in the byte
+ * starting at \c HookEventAttributesShift. Its \c lParam is the event's payload, to be read with \c ReadHookEventPayload.
+ * Being registered, the message can't be mistaken for any of the system's messages or a window's
+ * private \c WM_USER messages, so no filtering is needed to pick out hook events.
+ */
+HOOKS_API UINT __cdecl GetHookEventMessage();
+
+/**
+ * Reads the message parameters of a hook event received by a destination window.
+ * @param header The header of the hook event, provided by the \c wParam of the hook event message.
+ * @param payloadIndex The hook event's payload, provided by the \c lParam of the hook event message.
+ * @param payload A pointer to the variable that receives the hook event's message parameters.
+ * @return True if the payload was read; false if it has since been overwritten by the payloads of later hook events.
+ * @note
+ * Hook events posted by low-level hook procedures carry their parameters packed into the \c lParam itself, and so are
+ * always read. All other hook events are sent, with their parameters held in a ring shared by all hook procedures that
+ * is only overwritten once thousands of them are waiting on their destinations at once. This should be called exactly
+ * once for every hook event message, while it is being processed.
+ */
+HOOKS_API bool __cdecl ReadHookEventPayload(WPARAM header, LPARAM payloadIndex, HookEventPayload* payload);
+
 /**
  * Changes the details of a hook message currently being intercepted.
  * @param message The message identifier to use.
@@ -80,10 +193,98 @@ HOOKS_API bool __cdecl RemoveHook(HookType hookType, int threadId);
  * @param lParam Additional information about the message to use.
  * @note
  * This function should only be called from window procedures that handle hook types supporting
- * mutable messages.
+ * mutable messages, and applies to the hook message whose payload was last read on the calling thread
+ * with \c ReadHookEventPayload.
  */
 HOOKS_API void __cdecl ChangeMessageDetails(UINT message, WPARAM wParam, LPARAM lParam);
 
+/**
+ * Retrieves the message pump activity recorded for a thread with an installed \c WH_GETMESSAGE hook procedure.
+ * @param threadId The identifier of the thread to retrieve message pump activity for.
+ * @param pumpData A pointer to the variable that receives the message pump activity.
+ * @return True if activity is being recorded for the thread; otherwise, false.
+ */
+HOOKS_API bool __cdecl GetMessagePumpData(int threadId, PumpData* pumpData);
+
+/**
+ * Retrieves the contention for the mutex guarding the shared hook registry, accumulated across all processes since the
+ * registry was first created.
+ * @param contention A pointer to the variable that receives the contention for the mutex.
+ * @return True if the contention was retrieved; otherwise, false.
+ */
+HOOKS_API bool __cdecl GetRegistryContention(RegistryContention* contention);
+
+/**
+ * Probes the responsiveness of a thread's message pump by posting a \c WM_NULL message to its queue.
+ * @param threadId The identifier of the thread to probe.
+ * @return True if successful; otherwise, false.
+ * @remarks
+ * An idle thread blocked in \c GetMessage is indistinguishable from a stalled one by pump activity alone. The probe
+ * gives an idle thread something to retrieve, with the time it takes to do so recorded as its probe response time.
+ */
+HOOKS_API bool __cdecl ProbeMessagePump(int threadId);
+
+/**
+ * Reads the tracing details of the oldest hook message received by a destination window from a low-level input hook
+ * procedure installed with the \c TraceEvents option.
+ * @param hookType The type of low-level hook procedure that sent the message: \c LowLevelKeyboard or \c LowLevelMouse.
+ * @param destination A handle to the window that received the message.
+ * @param stamp A pointer to the variable that receives the message's tracing details.
+ * @return True if a stamp was read; otherwise, false.
+ * @note
+ * This function should only be called by the thread that owns \c destination, exactly once for every hook message it
+ * receives, as stamps are queued in the same order as their messages.
+ */
+HOOKS_API bool __cdecl ReadEventStamp(HookType hookType, HWND destination, EventStamp* stamp);
+
+/**
+ * Retrieves the number of events a low-level input hook procedure captured but failed to deliver to its destination,
+ * typically because the destination's message queue was full.
+ * @param hookType The type of low-level hook procedure: \c LowLevelKeyboard or \c LowLevelMouse.
+ * @param threadId The identifier of the thread the hook procedure is associated with.
+ * @param droppedEventCount A pointer to the variable that receives the number of events dropped.
+ * @return True if the hook procedure is installed; otherwise, false.
+ */
+HOOKS_API bool __cdecl GetDroppedEventCount(HookType hookType, int threadId, LONG* droppedEventCount);
+
+/**
+ * Registers a window to receive raw input from all keyboards or mice, as a lower overhead alternative to installing a
+ * low-level input hook procedure.
+ * @param hookType The type of low-level hook procedure whose input is to be captured: \c LowLevelKeyboard or
+ * \c LowLevelMouse.
+ * @param destination A handle to the window that will receive \c WM_INPUT messages, even while it isn't in the foreground.
+ * @return True if successful; otherwise, false.
+ * @remarks
+ * Unlike a low-level hook procedure, which the system calls synchronously before any application sees the input, raw
+ * input is queued to the destination window asynchronously. Monitoring input this way adds no latency for other
+ * applications and can never trip the system's \c LowLevelHooksTimeout. Raw input registrations are process-wide, so
+ * only one window per process can receive raw input from a particular type of device.
+ */
+HOOKS_API bool __cdecl RegisterRawInput(HookType hookType, HWND destination);
+
+/**
+ * Stops the delivery of raw input from all keyboards or mice to the window registered for it.
+ * @param hookType The type of low-level hook procedure whose input is being captured: \c LowLevelKeyboard or
+ * \c LowLevelMouse.
+ * @return True if successful; otherwise, false.
+ */
+HOOKS_API bool __cdecl UnregisterRawInput(HookType hookType);
+
+/**
+ * Reads raw input queued for the calling thread in bulk, translating it into the input events that the low-level
+ * keyboard and mouse hook procedures send to their listeners.
+ * @param input
+ * A handle to the raw input provided by the \c WM_INPUT message currently being processed, or a \c nullptr if the
+ * thread's queued raw input is to be read without one.
+ * @param events A pointer to an array that receives the translated input events.
+ * @param capacity The number of input events \c events can hold, which must be at least 13.
+ * @return The number of input events written to \c events, or -1 if \c capacity is too small.
+ * @note
+ * This function should only be called by the thread that owns the window registered with \c RegisterRawInput. If the
+ * number of events returned is nearly \c capacity, more raw input may remain, and the function should be called again.
+ */
+HOOKS_API int __cdecl ReadRawInput(HRAWINPUT input, InputEvent* events, int capacity);
+
 // Installable hook procedures.
 
 LRESULT CALLBACK CallWndProc(int nCode, WPARAM wParam, LPARAM lParam);
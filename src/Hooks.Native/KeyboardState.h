@@ -0,0 +1,198 @@
+// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+#pragma once
+
+#include <iterator>
+
+#include "HookTypes.h"
+
+/**
+ * Provides incrementally maintained modifier and toggle key states, derived from the keyboard input events a hook
+ * procedure sees.
+ * @remarks
+ * Left and right modifier keys are tracked separately, so that releasing one doesn't clear the modifier while the other
+ * is still held. This has no dependency on the Windows headers, so that it can be shared with portable input translation
+ * code.
+ */
+class KeyboardState
+{
+public:
+	/**
+	 * The virtual-key codes of the keys whose states can be seeded with \c Seed, in the order of their bits.
+	 */
+	static constexpr unsigned int TrackedKeys[] = {
+		0xA0, // VK_LSHIFT
+		0xA1, // VK_RSHIFT
+		0xA2, // VK_LCONTROL
+		0xA3, // VK_RCONTROL
+		0xA4, // VK_LMENU
+		0xA5, // VK_RMENU
+		0x5B, // VK_LWIN
+		0x5C, // VK_RWIN
+		0x14, // VK_CAPITAL
+		0x90, // VK_NUMLOCK
+		0x91  // VK_SCROLL
+	};
+
+	/**
+	 * Gets a value indicating if the key states have been seeded yet.
+	 * @return True if the key states have been seeded; otherwise, false.
+	 */
+	bool IsSeeded() const
+	{
+		return _seeded;
+	}
+
+	/**
+	 * Seeds the key states, typically with a one-time query of the actual keyboard state.
+	 * @param heldKeys Bits, ordered as in \c TrackedKeys, indicating which keys are currently held.
+	 * @param toggles The toggle key states currently on.
+	 */
+	void Seed(unsigned int heldKeys, KeyboardModifiers toggles)
+	{
+		_heldKeys = heldKeys;
+		_toggles = static_cast<unsigned char>(toggles & ToggleMask);
+		_seeded = true;
+		_stale = false;
+	}
+
+	/**
+	 * Gets a value indicating if the key states should be resynced with the actual keyboard state before the next keyboard
+	 * input event is applied.
+	 * @return True if the key states were never seeded or have since been invalidated; otherwise, false.
+	 */
+	bool NeedsResync() const
+	{
+		return !_seeded || _stale;
+	}
+
+	/**
+	 * Marks the key states as possibly out of sync with the actual keyboard state, such as after the keyboard focus has
+	 * moved to another thread, whose input events are never seen.
+	 */
+	void Invalidate()
+	{
+		_stale = true;
+	}
+
+	/**
+	 * Brings the key states back in line with the actual keyboard state, correcting for input events that were never seen.
+	 * @param heldKeys Bits, ordered as in \c TrackedKeys, indicating which keys are actually held.
+	 * @param toggles The toggle key states actually on.
+	 * @return True if the key states had fallen out of sync with the actual keyboard state; otherwise, false.
+	 * @remarks
+	 * Hook procedures that only see the input sent to a single thread miss every key pressed or released while another
+	 * thread has the keyboard focus, which would otherwise leave modifiers stuck until they're next pressed and released.
+	 */
+	bool Resync(unsigned int heldKeys, KeyboardModifiers toggles)
+	{
+		bool outOfSync = _seeded && (_heldKeys != heldKeys || _toggles != (toggles & ToggleMask));
+
+		Seed(heldKeys, toggles);
+
+		return outOfSync;
+	}
+
+	/**
+	 * Updates the key states with a keyboard input event.
+	 * @param virtualKey The virtual-key code of the key that generated the event.
+	 * @param isKeyUp Value indicating if the key was released, as opposed to pressed.
+	 * @param isExtended Value indicating if the key is an extended key.
+	 * @param scanCode The hardware scan code of the key.
+	 * @return The modifier and toggle key states after the event has been applied.
+	 */
+	KeyboardModifiers Update(unsigned int virtualKey, bool isKeyUp, bool isExtended, unsigned int scanCode)
+	{
+		int bit = FindKeyBit(virtualKey, isExtended, scanCode);
+
+		if (bit < 0)
+			return Modifiers();
+
+		unsigned int keyMask = 1U << bit;
+
+		if (isKeyUp)
+		{
+			_heldKeys &= ~keyMask;
+		}
+		else
+		{	// Toggle keys flip on the transition to being pressed, and not on any subsequent auto-repeats.
+			if (bit >= CapsLockBit && (_heldKeys & keyMask) == 0)
+				_toggles ^= ToggleFromBit(bit);
+
+			_heldKeys |= keyMask;
+		}
+
+		return Modifiers();
+	}
+
+	/**
+	 * Gets the current modifier and toggle key states.
+	 * @return The current modifier and toggle key states.
+	 */
+	KeyboardModifiers Modifiers() const
+	{
+		unsigned int modifiers = _toggles;
+
+		if ((_heldKeys & 0x3) != 0)
+			modifiers |= ShiftModifier;
+
+		if ((_heldKeys & 0xC) != 0)
+			modifiers |= ControlModifier;
+
+		if ((_heldKeys & 0x30) != 0)
+			modifiers |= AltModifier;
+
+		if ((_heldKeys & 0xC0) != 0)
+			modifiers |= WindowsModifier;
+
+		return static_cast<KeyboardModifiers>(modifiers);
+	}
+
+private:
+	static constexpr int CapsLockBit = 8;
+	static constexpr unsigned int RightShiftScanCode = 0x36;
+	static constexpr unsigned char ToggleMask = CapsLockToggled | NumLockToggled | ScrollLockToggled;
+
+	static unsigned char ToggleFromBit(int bit)
+	{
+		return static_cast<unsigned char>(CapsLockToggled << (bit - CapsLockBit));
+	}
+
+	static int FindKeyBit(unsigned int virtualKey, bool isExtended, unsigned int scanCode)
+	{	// Non-low-level keyboard hooks report the side-agnostic VK_SHIFT, VK_CONTROL, and VK_MENU codes, leaving us to
+		// work out the side from the scan code (for SHIFT) or extended key flag (for CTRL and ALT).
+		switch (virtualKey)
+		{
+			case 0x10: // VK_SHIFT
+				return scanCode == RightShiftScanCode ? 1 : 0;
+			case 0x11: // VK_CONTROL
+				return isExtended ? 3 : 2;
+			case 0x12: // VK_MENU
+				return isExtended ? 5 : 4;
+			default:
+				for (int bit = 0; bit < static_cast<int>(std::size(TrackedKeys)); bit++)
+				{
+					if (TrackedKeys[bit] == virtualKey)
+						return bit;
+				}
+
+				return -1;
+		}
+	}
+
+	unsigned int _heldKeys = 0;
+	unsigned char _toggles = 0;
+	bool _seeded = false;
+	bool _stale = false;
+};
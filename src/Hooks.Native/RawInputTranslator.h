@@ -0,0 +1,348 @@
+// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "HookTypes.h"
+#include "KeyboardState.h"
+
+/**
+ * Represents the header of a raw input block, laid out identically to \c RAWINPUTHEADER.
+ */
+struct RawInputHeader
+{
+	/**
+	 * The type of device that generated the raw input: \c RIM_TYPEMOUSE, \c RIM_TYPEKEYBOARD, or \c RIM_TYPEHID.
+	 */
+	std::uint32_t Type;
+	/**
+	 * The size, in bytes, of the entire raw input block, including this header.
+	 */
+	std::uint32_t Size;
+	/**
+	 * A handle to the device that generated the raw input.
+	 */
+	std::uintptr_t Device;
+	/**
+	 * The \c wParam of the \c WM_INPUT message that delivered the raw input.
+	 */
+	std::uintptr_t WParam;
+};
+
+/**
+ * Represents raw input from a keyboard, laid out identically to \c RAWKEYBOARD.
+ */
+struct RawKeyboardInput
+{
+	/**
+	 * The scan code of the key.
+	 */
+	std::uint16_t MakeCode;
+	/**
+	 * Flags for scan code information: \c RI_KEY_BREAK, \c RI_KEY_E0, and \c RI_KEY_E1.
+	 */
+	std::uint16_t Flags;
+	/**
+	 * Reserved.
+	 */
+	std::uint16_t Reserved;
+	/**
+	 * The legacy virtual-key code of the key.
+	 */
+	std::uint16_t VirtualKey;
+	/**
+	 * The corresponding legacy keyboard window message, such as \c WM_KEYDOWN or \c WM_SYSKEYUP.
+	 */
+	std::uint32_t Message;
+	/**
+	 * Additional device-specific information for the event.
+	 */
+	std::uint32_t ExtraInformation;
+};
+
+/**
+ * Represents raw input from a mouse, laid out identically to \c RAWMOUSE.
+ */
+struct RawMouseInput
+{
+	/**
+	 * The mouse state, such as \c MOUSE_MOVE_ABSOLUTE.
+	 */
+	std::uint16_t Flags;
+	/**
+	 * Reserved.
+	 */
+	std::uint16_t Reserved;
+	/**
+	 * The transition state of the mouse buttons, such as \c RI_MOUSE_LEFT_BUTTON_DOWN.
+	 */
+	std::uint16_t ButtonFlags;
+	/**
+	 * The wheel delta, if a wheel was rotated.
+	 */
+	std::int16_t ButtonData;
+	/**
+	 * The raw state of the mouse buttons.
+	 */
+	std::uint32_t RawButtons;
+	/**
+	 * The motion in the X direction, either signed relative motion or an absolute position.
+	 */
+	std::int32_t LastX;
+	/**
+	 * The motion in the Y direction, either signed relative motion or an absolute position.
+	 */
+	std::int32_t LastY;
+	/**
+	 * Additional device-specific information for the event.
+	 */
+	std::uint32_t ExtraInformation;
+};
+
+/**
+ * Provides translation of raw keyboard and mouse input into the same input events that the low-level keyboard and mouse
+ * hook procedures send to their listeners.
+ * @remarks
+ * This has no dependency on the Windows headers, allowing recorded raw input buffers to be translated on any platform.
+ * An instance maintains the keyboard's modifier and toggle key states across everything it translates, and should be
+ * fed all raw input for a thread in the order it was read.
+ */
+class RawInputTranslator
+{
+public:
+	/**
+	 * The maximum number of input events a single raw input block can be translated into: a mouse move, five button
+	 * presses and releases, and two wheel rotations.
+	 */
+	static constexpr std::size_t MaxEventsPerInput = 13;
+
+	/**
+	 * Gets the keyboard state maintained from the translated raw keyboard input.
+	 * @return The keyboard state maintained from the translated raw keyboard input.
+	 */
+	KeyboardState& Keyboard()
+	{
+		return _keyboardState;
+	}
+
+	/**
+	 * Translates a buffer of raw input blocks, such as that filled by \c GetRawInputBuffer or \c GetRawInputData, into
+	 * input events.
+	 * @param buffer The buffer containing the raw input blocks, aligned as \c GetRawInputBuffer aligns them.
+	 * @param size The size, in bytes, of \c buffer.
+	 * @param count The number of raw input blocks in \c buffer.
+	 * @param headerPadding
+	 * The number of bytes separating each block's header from its device data; this is 8 for buffers filled by
+	 * \c GetRawInputBuffer in 32-bit processes running on 64-bit Windows, and 0 otherwise.
+	 * @param cursorX The x-coordinate of the cursor, in screen coordinates, to report with mouse input events.
+	 * @param cursorY The y-coordinate of the cursor, in screen coordinates, to report with mouse input events.
+	 * @param events The array that receives the translated input events.
+	 * @param capacity
+	 * The number of input events \c events can hold. Translation stops early, before the first block that might not fit.
+	 * @return The number of input events written to \c events.
+	 * @remarks
+	 * Raw mouse input reports device motion rather than cursor position, which the system derives only after applying
+	 * pointer acceleration. Mouse input events therefore all report the cursor position supplied by the caller, which
+	 * should be queried once at the time the buffer was read.
+	 */
+	std::size_t TranslateBuffer(const void* buffer,
+	                            std::size_t size,
+	                            unsigned int count,
+	                            std::size_t headerPadding,
+	                            int cursorX,
+	                            int cursorY,
+	                            InputEvent* events,
+	                            std::size_t capacity)
+	{
+		auto bytes = static_cast<const unsigned char*>(buffer);
+		std::size_t offset = 0;
+		std::size_t written = 0;
+
+		for (unsigned int i = 0; i < count && capacity - written >= MaxEventsPerInput; i++)
+		{
+			if (size - offset < sizeof(RawInputHeader))
+				break;
+
+			RawInputHeader header;
+			std::memcpy(&header, bytes + offset, sizeof(header));
+
+			std::size_t dataOffset = offset + sizeof(RawInputHeader) + headerPadding;
+
+			if (header.Size < sizeof(RawInputHeader) || header.Size > size - offset || dataOffset > size)
+				break;
+
+			switch (header.Type)
+			{
+				case MouseInputType:
+					if (size - dataOffset >= sizeof(RawMouseInput))
+					{
+						RawMouseInput mouse;
+						std::memcpy(&mouse, bytes + dataOffset, sizeof(mouse));
+
+						written += TranslateMouse(mouse, cursorX, cursorY, events + written);
+					}
+					break;
+
+				case KeyboardInputType:
+					if (size - dataOffset >= sizeof(RawKeyboardInput))
+					{
+						RawKeyboardInput keyboard;
+						std::memcpy(&keyboard, bytes + dataOffset, sizeof(keyboard));
+
+						written += TranslateKeyboard(keyboard, events + written);
+					}
+					break;
+
+				default:
+					break;
+			}
+
+			// Blocks are aligned to pointer-sized boundaries, exactly as the NEXTRAWINPUTBLOCK macro expects.
+			offset = (offset + header.Size + BlockAlignment - 1) & ~(BlockAlignment - 1);
+
+			if (offset > size)
+				break;
+		}
+
+		return written;
+	}
+
+private:
+	static constexpr std::uint32_t MouseInputType = 0;
+	static constexpr std::uint32_t KeyboardInputType = 1;
+	static constexpr std::size_t BlockAlignment = sizeof(std::uintptr_t);
+
+	static constexpr std::uint16_t KeyBreak = 0x1;
+	static constexpr std::uint16_t KeyE0 = 0x2;
+	static constexpr std::uint16_t FakeVirtualKey = 0xFF;
+	static constexpr std::uint16_t RightShiftScanCode = 0x36;
+	static constexpr std::uint16_t MoveAbsolute = 0x1;
+
+	static constexpr std::intptr_t ExtendedKeyFlag = 0x1; // LLKHF_EXTENDED
+	static constexpr std::intptr_t AltDownFlag = 0x20;    // LLKHF_ALTDOWN
+	static constexpr std::intptr_t KeyUpFlag = 0x80;      // LLKHF_UP
+
+	struct ButtonTransition
+	{
+		std::uint16_t Flag;
+		unsigned int Message;
+	};
+
+	static constexpr ButtonTransition ButtonTransitions[] = {
+		{ 0x0001, 0x0201 }, // RI_MOUSE_LEFT_BUTTON_DOWN, WM_LBUTTONDOWN
+		{ 0x0002, 0x0202 }, // RI_MOUSE_LEFT_BUTTON_UP, WM_LBUTTONUP
+		{ 0x0004, 0x0204 }, // RI_MOUSE_RIGHT_BUTTON_DOWN, WM_RBUTTONDOWN
+		{ 0x0008, 0x0205 }, // RI_MOUSE_RIGHT_BUTTON_UP, WM_RBUTTONUP
+		{ 0x0010, 0x0207 }, // RI_MOUSE_MIDDLE_BUTTON_DOWN, WM_MBUTTONDOWN
+		{ 0x0020, 0x0208 }, // RI_MOUSE_MIDDLE_BUTTON_UP, WM_MBUTTONUP
+		{ 0x0040, 0x020B }, // RI_MOUSE_BUTTON_4_DOWN, WM_XBUTTONDOWN
+		{ 0x0080, 0x020C }, // RI_MOUSE_BUTTON_4_UP, WM_XBUTTONUP
+		{ 0x0100, 0x020B }, // RI_MOUSE_BUTTON_5_DOWN, WM_XBUTTONDOWN
+		{ 0x0200, 0x020C }, // RI_MOUSE_BUTTON_5_UP, WM_XBUTTONUP
+		{ 0x0400, 0x020A }, // RI_MOUSE_WHEEL, WM_MOUSEWHEEL
+		{ 0x0800, 0x020E }  // RI_MOUSE_HWHEEL, WM_MOUSEHWHEEL
+	};
+
+	static unsigned int ToSidedVirtualKey(unsigned int virtualKey, bool isExtended, unsigned int scanCode)
+	{	// Raw input reports the side-agnostic SHIFT, CTRL, and ALT codes, whereas low-level hooks report which side it was.
+		switch (virtualKey)
+		{
+			case 0x10: // VK_SHIFT
+				return scanCode == RightShiftScanCode ? 0xA1 : 0xA0;
+			case 0x11: // VK_CONTROL
+				return isExtended ? 0xA3 : 0xA2;
+			case 0x12: // VK_MENU
+				return isExtended ? 0xA5 : 0xA4;
+			default:
+				return virtualKey;
+		}
+	}
+
+	static bool IsKeyboardMessage(unsigned int message)
+	{	// WM_KEYDOWN, WM_KEYUP, WM_SYSKEYDOWN, and WM_SYSKEYUP.
+		return message == 0x100 || message == 0x101 || message == 0x104 || message == 0x105;
+	}
+
+	std::size_t TranslateKeyboard(const RawKeyboardInput& keyboard, InputEvent* events)
+	{	// Keys sent as part of an escape sequence (such as the fake SHIFT accompanying some navigation keys) are reported
+		// with a virtual-key code of 0xFF; low-level hooks never see these.
+		if (keyboard.VirtualKey == FakeVirtualKey || keyboard.VirtualKey == 0)
+			return 0;
+
+		bool isKeyUp = (keyboard.Flags & KeyBreak) == KeyBreak;
+		bool isExtended = (keyboard.Flags & KeyE0) == KeyE0;
+		unsigned int virtualKey = ToSidedVirtualKey(keyboard.VirtualKey, isExtended, keyboard.MakeCode);
+
+		KeyboardModifiers modifiers = _keyboardState.Update(virtualKey, isKeyUp, isExtended, keyboard.MakeCode);
+		bool isAltDown = (modifiers & AltModifier) == AltModifier;
+
+		unsigned int message = keyboard.Message;
+
+		if (!IsKeyboardMessage(message))
+		{	// The system keystroke messages are used when ALT is held without CTRL, exactly as the legacy messages would be.
+			bool isSystemKey = isAltDown && (modifiers & ControlModifier) == 0;
+
+			message = (isKeyUp ? 0x101 : 0x100) + (isSystemKey ? 0x4 : 0x0);
+		}
+
+		std::intptr_t flags = 0;
+
+		if (isExtended)
+			flags |= ExtendedKeyFlag;
+
+		if (isAltDown)
+			flags |= AltDownFlag;
+
+		if (isKeyUp)
+			flags |= KeyUpFlag;
+
+		events[0] = {
+			.Message = message,
+			.WParam = static_cast<std::uintptr_t>(virtualKey) | static_cast<std::uintptr_t>(modifiers) << KeyboardModifiersShift,
+			.LParam = flags
+		};
+
+		return 1;
+	}
+
+	static std::size_t TranslateMouse(const RawMouseInput& mouse, int cursorX, int cursorY, InputEvent* events)
+	{
+		std::size_t written = 0;
+
+		auto write = [&](unsigned int message)
+		{
+			events[written++] = {
+				.Message = message,
+				.WParam = static_cast<std::uintptr_t>(static_cast<std::intptr_t>(cursorX)),
+				.LParam = cursorY
+			};
+		};
+
+		if ((mouse.Flags & MoveAbsolute) == MoveAbsolute || mouse.LastX != 0 || mouse.LastY != 0)
+			write(0x200); // WM_MOUSEMOVE
+
+		for (const ButtonTransition& transition : ButtonTransitions)
+		{
+			if ((mouse.ButtonFlags & transition.Flag) == transition.Flag)
+				write(transition.Message);
+		}
+
+		return written;
+	}
+
+	KeyboardState _keyboardState;
+};
@@ -15,6 +15,7 @@
 
 namespace {
     ThreadData* SharedData = nullptr;
+    HookEventSlot* HookEventSlots = nullptr;
     LPVOID SharedMemory = nullptr;
     HANDLE FileMapping = nullptr;
     
@@ -45,34 +46,117 @@ namespace {
     }
 
     int FindThreadDataIndex(int threadId)
-    {
-        int index;
+    {   // Free slots have a thread identifier of zero, so it must never be looked up.
+        if (threadId == 0)
+            return -1;
 
-        for (index = 0; index < ThreadCount; index++)
+        for (int index = 0; index < ThreadSlotCount; index++)
         {
             if (SharedData[index].ThreadId == threadId)
-                break;
+                return index;
         }
 
-        return index;
+        return -1;
     }
 
     ThreadData* GetThreadData(HookType hookType, int threadId)
     {
         int index = FindThreadDataIndex(threadId);
 
-        if (index == ThreadCount || threadId == 0)
+        if (index == -1)
         {
             if (int* globalId = GetGlobalId(hookType); globalId != nullptr)
                 index = FindThreadDataIndex(*globalId);
 
-            if (index == ThreadCount)
+            if (index == -1)
                 return nullptr;
         }
 
         return &SharedData[index];
     }
 
+    ThreadData* GetOwningThreadData(const HookData* hookData)
+    {
+        auto offset = reinterpret_cast<const char*>(hookData) - reinterpret_cast<const char*>(SharedData);
+
+        return &SharedData[offset / static_cast<ptrdiff_t>(sizeof(ThreadData))];
+    }
+
+    // The following functions must only be called while owning the SharedSectionMutex.
+
+    int AllocateThreadDataIndex(int threadId)
+    {
+        int index = FindThreadDataIndex(threadId);
+
+        if (index != -1)
+            return index;
+
+        // Slots freed below the highest one in use are left as holes to be reused here, as shifting the slots above them
+        // down would pull live data out from under the hook procedures reading it.
+        for (index = 0; index < ThreadSlotCount; index++)
+        {
+            if (SharedData[index].ThreadId == 0)
+                break;
+        }
+
+        if (index == MaxThreads)
+            return -1;
+
+        SharedData[index] = ThreadData{};
+        SharedData[index].ThreadId = threadId;
+
+        if (index == ThreadSlotCount)
+            ThreadSlotCount++;
+
+        ThreadCount++;
+
+        return index;
+    }
+
+    bool HasHooks(const ThreadData* threadData)
+    {
+        return threadData->CallWndProcHook.Handle != nullptr
+            || threadData->CallWndProcRetHook.Handle != nullptr
+            || threadData->GetMessageHook.Handle != nullptr
+            || threadData->KeyboardHook.Handle != nullptr
+            || threadData->LowLevelKeyboardHook.Handle != nullptr
+            || threadData->MouseHook.Handle != nullptr
+            || threadData->LowLevelMouseHook.Handle != nullptr;
+    }
+
+    void FreeThreadData(ThreadData* threadData)
+    {
+        if (threadData->ThreadId == 0 || HasHooks(threadData))
+            return;
+
+        // "Free" the thread, as it no longer has any hooks associated with it.
+        threadData->ThreadId = 0;
+        ThreadCount--;
+
+        while (ThreadSlotCount > 0 && SharedData[ThreadSlotCount - 1].ThreadId == 0)
+        {
+            ThreadSlotCount--;
+        }
+    }
+
+    void ClearHookData(HookType hookType, HookData* hookData)
+    {
+        ThreadData* threadData = GetOwningThreadData(hookData);
+
+        if (int* globalId = GetGlobalId(hookType); globalId != nullptr && *globalId == threadData->ThreadId)
+            *globalId = 0;
+
+        *hookData = HookData{};
+    }
+
+    unsigned int HashShardKey(uintptr_t key)
+    {   // Thread identifiers and window handles tend to be multiples of four, which would leave most shards unused if we
+        // simply took the key modulo the shard count. Fibonacci hashing spreads them out.
+        auto hash = static_cast<unsigned int>(key) * 2654435769U;
+
+        return hash >> 16;
+    }
+
     HookData* GetThreadHookData(HookType hookType, ThreadData* threadData)
     {
         switch (hookType)
@@ -95,21 +179,37 @@ namespace {
 
         return nullptr;
     }
+
+    void LockSharedSection()
+    {   // Only waits on a mutex held by someone else are timed, so that the uncontended path costs nothing extra.
+        if (WaitForSingleObject(SharedSectionMutex, 0) != WAIT_TIMEOUT)
+            return;
+
+        LARGE_INTEGER start;
+        LARGE_INTEGER end;
+
+        QueryPerformanceCounter(&start);
+        WaitForSingleObject(SharedSectionMutex, INFINITE);
+        QueryPerformanceCounter(&end);
+
+        InterlockedIncrement64(&SharedSectionWaitCount);
+        InterlockedExchangeAdd64(&SharedSectionWaitTicks, end.QuadPart - start.QuadPart);
+    }
 }
 
-// Mutex for synchronizing writes to shared memory, particularly for message parameter modification by message queue hook procedures.
+// Mutex for synchronizing writes to shared memory, particularly the registry of hook data.
 HANDLE SharedSectionMutex = nullptr;
 
 // Adds a data section to our binary file for variables we want shared across all processes.
 #pragma data_seg(".shared")
-bool ChangeMessage = false;
-UINT ChangedMessage = 0;
-WPARAM ChangedWParam = 0;
-LPARAM ChangedLParam = 0;
 int ThreadCount = 0;
+int ThreadSlotCount = 0;
+LONG HookEventPayloadIndex = 0;
 int GlobalCallWndProcId = 0;
 int GlobalCallWndProcRetId = 0;
 int GlobalGetMessageId = 0;
+LONGLONG SharedSectionWaitCount = 0;
+LONGLONG SharedSectionWaitTicks = 0;
 #pragma data_seg()
 #pragma comment(linker, "/SECTION:.shared,RWS") 
 
@@ -121,7 +221,7 @@ bool InitializeSharedData()
         nullptr,
         PAGE_READWRITE,
         0,
-        SharedMemorySize,
+        static_cast<DWORD>(SharedMemorySize),
         TEXT("BadEcho.Hooks.FileMappingObject"));
 
     if (FileMapping == nullptr)
@@ -145,6 +245,7 @@ bool InitializeSharedData()
         memset(SharedMemory, '\0', SharedMemorySize);
 
     SharedData = static_cast<ThreadData*>(SharedMemory);
+    HookEventSlots = reinterpret_cast<HookEventSlot*>(SharedData + MaxThreads);
 
     return true;
 }
@@ -163,46 +264,22 @@ HookData* AddHookData(HookType hookType, int threadId)
     if (isGlobal)
         threadId = static_cast<int>(GetCurrentThreadId());
 
-    int index = FindThreadDataIndex(threadId);
+    // Synchronization is required as multiple processes may be attempting to claim the same slot.
+    LockSharedSection();
 
-    if (index == ThreadCount)
-    {   // Thread not registered -- attempt to initialize data.
-        if (ThreadCount == MaxThreads)
-        {   // We're at our storage limit -- check if any threads have been freed.
-            for (index = 0; index < ThreadCount; index++)
-            {
-                if (SharedData[index].ThreadId == 0)
-                    break;
-            }
-
-            if (index == MaxThreads)
-                return nullptr;
-        }
+    HookData* hookData = nullptr;
 
-        SharedData[index].ThreadId = threadId;
-        
-        SharedData[index].CallWndProcHook.Handle = nullptr;
-        SharedData[index].CallWndProcHook.Destination = nullptr;
-        SharedData[index].CallWndProcRetHook.Handle = nullptr;
-        SharedData[index].CallWndProcRetHook.Destination = nullptr;
-        SharedData[index].GetMessageHook.Handle = nullptr;
-        SharedData[index].GetMessageHook.Destination = nullptr;
-        SharedData[index].KeyboardHook.Handle = nullptr;
-        SharedData[index].KeyboardHook.Destination = nullptr;
-        SharedData[index].LowLevelKeyboardHook.Handle = nullptr;
-        SharedData[index].LowLevelKeyboardHook.Destination = nullptr;
-
-        // Synchronization is required as multiple processes may be attempting to increment the
-        // thread count.
-        WaitForSingleObject(SharedSectionMutex, INFINITE);
-        ThreadCount++;
-        ReleaseMutex(SharedSectionMutex);
+    if (int index = AllocateThreadDataIndex(threadId); index != -1)
+    {
+        hookData = GetThreadHookData(hookType, &SharedData[index]);
+
+        if (isGlobal)
+            UpdateGlobalId(hookType, threadId);
     }
 
-    if (isGlobal)
-        UpdateGlobalId(hookType, threadId);
-    
-    return GetThreadHookData(hookType, &SharedData[index]);
+    ReleaseMutex(SharedSectionMutex);
+
+    return hookData;
 }
 
 HookData* GetHookData(HookType hookType, int threadId)
@@ -212,43 +289,306 @@ HookData* GetHookData(HookType hookType, int threadId)
 
     ThreadData* threadData = GetThreadData(hookType, threadId);
 
+    if (threadData == nullptr)
+        return nullptr;
+
     return GetThreadHookData(hookType, threadData);
 }
 
 void RemoveHookData(HookType hookType, int threadId)
+{   // Hook data is found the same way GetHookData does, which is how it was found when the hook procedure was uninstalled.
+    if (threadId == 0)
+        threadId = static_cast<int>(GetCurrentThreadId());
+
+    LockSharedSection();
+
+    if (ThreadData* threadData = GetThreadData(hookType, threadId); threadData != nullptr)
+    {
+        if (HookData* hookData = GetThreadHookData(hookType, threadData); hookData != nullptr)
+            ClearHookData(hookType, hookData);
+
+        FreeThreadData(threadData);
+    }
+
+    ReleaseMutex(SharedSectionMutex);
+}
+
+bool ReserveHookData(const HookChange* changes, int changeCount, HookData** hookData)
 {
-    ThreadData* threadData = GetThreadData(hookType, threadId);
+    auto currentThreadId = static_cast<int>(GetCurrentThreadId());
+    bool reserved = true;
+    int index;
 
-    if (threadData == nullptr)
-        return;
+    LockSharedSection();
+
+    // Uninstallations are resolved first, so that installations can take over the hook data they free up.
+    for (index = 0; index < changeCount && reserved; index++)
+    {
+        hookData[index] = nullptr;
 
-    HookData* hookData = GetThreadHookData(hookType, threadData);
+        if (changes[index].Action != UninstallHook)
+            continue;
 
-    if (threadId == 0)
-        UpdateGlobalId(hookType, 0);
+        int threadId = changes[index].ThreadId == 0 ? currentThreadId : changes[index].ThreadId;
 
-    hookData->Handle = nullptr;
-    hookData->Destination = nullptr;
+        if (ThreadData* threadData = GetThreadData(changes[index].Type, threadId); threadData != nullptr)
+            hookData[index] = GetThreadHookData(changes[index].Type, threadData);
 
-    if (threadData->CallWndProcHook.Handle != nullptr)
-        return;
+        reserved = hookData[index] != nullptr && hookData[index]->Handle != nullptr;
+    }
 
-    if (threadData->CallWndProcRetHook.Handle != nullptr)
-        return;
+    for (index = 0; index < changeCount && reserved; index++)
+    {
+        if (changes[index].Action != InstallHook)
+            continue;
 
-    if (threadData->GetMessageHook.Handle != nullptr)
-        return;
+        int threadId = changes[index].ThreadId == 0 ? currentThreadId : changes[index].ThreadId;
+        int threadIndex = AllocateThreadDataIndex(threadId);
 
-    if (threadData->KeyboardHook.Handle != nullptr)
-        return;
+        if (threadIndex == -1)
+        {
+            reserved = false;
+            break;
+        }
 
-    if (threadData->LowLevelKeyboardHook.Handle != nullptr)
-        return;
+        HookData* reservedData = GetThreadHookData(changes[index].Type, &SharedData[threadIndex]);
+        int claimCount = 0;
+
+        // Hook data can only be claimed once by an installation, and then only if it is free or being freed by the batch.
+        for (int other = 0; other < changeCount; other++)
+        {
+            if (other != index && hookData[other] == reservedData)
+                claimCount += changes[other].Action == InstallHook ? 2 : 1;
+        }
+
+        hookData[index] = reservedData;
+
+        if (reservedData == nullptr)
+            reserved = false;
+        else if (reservedData->Handle == nullptr)
+            reserved = claimCount == 0;
+        else
+            reserved = claimCount == 1;
+    }
+
+    if (!reserved)
+    {
+        for (int other = 0; other < changeCount; other++)
+        {
+            if (changes[other].Action == InstallHook && hookData[other] != nullptr)
+                FreeThreadData(GetOwningThreadData(hookData[other]));
+
+            hookData[other] = nullptr;
+        }
+    }
 
-    // "Free" the thread, as it no longer has any hooks associated with it.
-    threadData->ThreadId = 0;
-    
-	WaitForSingleObject(SharedSectionMutex, INFINITE);
-    ThreadCount--;
     ReleaseMutex(SharedSectionMutex);
+
+    return reserved;
+}
+
+void CommitHookData(const HookChange* changes, int changeCount, HookData* const* hookData, const HookData* installedData)
+{
+    auto currentThreadId = static_cast<int>(GetCurrentThreadId());
+
+    LockSharedSection();
+
+    for (int index = 0; index < changeCount; index++)
+    {
+        if (changes[index].Action == UninstallHook && changes[index].Succeeded)
+            ClearHookData(changes[index].Type, hookData[index]);
+    }
+
+    for (int index = 0; index < changeCount; index++)
+    {
+        if (changes[index].Action != InstallHook || !changes[index].Succeeded)
+            continue;
+
+        *hookData[index] = installedData[index];
+
+        if (changes[index].ThreadId == 0)
+            UpdateGlobalId(changes[index].Type, currentThreadId);
+    }
+
+    for (int index = 0; index < changeCount; index++)
+    {
+        if (hookData[index] != nullptr)
+            FreeThreadData(GetOwningThreadData(hookData[index]));
+    }
+
+    ReleaseMutex(SharedSectionMutex);
+}
+
+int ReserveOwnedHookData(int owner, HookChange* changes, int capacity, HookData** hookData)
+{
+    DWORD processId = GetCurrentProcessId();
+    int changeCount = 0;
+
+    LockSharedSection();
+
+    for (int index = 0; index < ThreadSlotCount; index++)
+    {
+        if (SharedData[index].ThreadId == 0)
+            continue;
+
+        for (int type = CallWindowProcedure; type <= LowLevelMouse && changeCount < capacity; type++)
+        {
+            auto hookType = static_cast<HookType>(type);
+            HookData* ownedData = GetThreadHookData(hookType, &SharedData[index]);
+
+            if (ownedData->Handle == nullptr || ownedData->OwnerProcessId != processId || ownedData->Owner != owner)
+                continue;
+
+            hookData[changeCount] = ownedData;
+            changes[changeCount++] = HookChange { hookType, UninstallHook, NoOptions, false, SharedData[index].ThreadId };
+        }
+    }
+
+    ReleaseMutex(SharedSectionMutex);
+
+    return changeCount;
+}
+
+HWND SelectDestination(HookData* hookData, int threadId, HWND window)
+{
+    int destinationCount = hookData->DestinationCount;
+
+    if (destinationCount <= 1)
+        return hookData->Destinations[0];
+
+    unsigned int key;
+
+    switch (hookData->Sharding)
+    {
+        case ShardByWindow:
+            if (window == nullptr)
+                return hookData->Destinations[0];
+
+            key = HashShardKey(reinterpret_cast<uintptr_t>(window));
+            break;
+
+        case ShardRoundRobin:
+            key = static_cast<unsigned int>(InterlockedIncrement(&hookData->RoundRobinCount));
+            break;
+
+        case ShardByThread:
+        default:
+            key = HashShardKey(static_cast<uintptr_t>(threadId));
+            break;
+    }
+
+    return hookData->Destinations[key % static_cast<unsigned int>(destinationCount)];
+}
+
+LONG StoreHookEventPayload(WPARAM wParam, LPARAM lParam)
+{
+    LONG payloadIndex;
+
+    // Zero marks a slot being written to, so it's skipped over on the rare occasion the payload index wraps around to it.
+    do
+    {
+        payloadIndex = InterlockedIncrement(&HookEventPayloadIndex);
+    } while (payloadIndex == 0);
+
+    HookEventSlot* slot = &HookEventSlots[static_cast<ULONG>(payloadIndex) & (HookEventSlotCount - 1)];
+
+    // A slot is marked before it's overwritten, so that a reader still holding the index of the slot's previous payload
+    // can tell it was changed out from under it.
+    InterlockedExchange(&slot->PayloadIndex, 0);
+
+    slot->WParam = wParam;
+    slot->LParam = lParam;
+    slot->Changed = FALSE;
+
+    InterlockedExchange(&slot->PayloadIndex, payloadIndex);
+
+    return payloadIndex;
+}
+
+bool LoadHookEventPayload(LONG payloadIndex, HookEventPayload* payload)
+{
+    if (payloadIndex == 0)
+        return false;
+
+    HookEventSlot* slot = &HookEventSlots[static_cast<ULONG>(payloadIndex) & (HookEventSlotCount - 1)];
+
+    if (InterlockedCompareExchange(&slot->PayloadIndex, 0, 0) != payloadIndex)
+        return false;
+
+    payload->WParam = slot->WParam;
+    payload->LParam = slot->LParam;
+
+    MemoryBarrier();
+
+    // If the slot is still marked with our index, then nothing could have started overwriting it while we were reading.
+    return InterlockedCompareExchange(&slot->PayloadIndex, 0, 0) == payloadIndex;
+}
+
+bool ChangeHookEventPayload(LONG payloadIndex, UINT message, WPARAM wParam, LPARAM lParam)
+{   // The hook procedure is blocked waiting on its destination while this is called, so it won't be reading the slot.
+    if (payloadIndex == 0)
+        return false;
+
+    HookEventSlot* slot = &HookEventSlots[static_cast<ULONG>(payloadIndex) & (HookEventSlotCount - 1)];
+
+    if (InterlockedCompareExchange(&slot->PayloadIndex, 0, 0) != payloadIndex)
+        return false;
+
+    slot->ChangedMessage = message;
+    slot->WParam = wParam;
+    slot->LParam = lParam;
+
+    InterlockedExchange(&slot->Changed, TRUE);
+
+    return InterlockedCompareExchange(&slot->PayloadIndex, 0, 0) == payloadIndex;
+}
+
+bool LoadChangedHookEventPayload(LONG payloadIndex, UINT* message, HookEventPayload* payload)
+{
+    if (payloadIndex == 0)
+        return false;
+
+    HookEventSlot* slot = &HookEventSlots[static_cast<ULONG>(payloadIndex) & (HookEventSlotCount - 1)];
+
+    if (InterlockedCompareExchange(&slot->PayloadIndex, 0, 0) != payloadIndex
+        || InterlockedCompareExchange(&slot->Changed, 0, 0) != TRUE)
+    {
+        return false;
+    }
+
+    *message = slot->ChangedMessage;
+    payload->WParam = slot->WParam;
+    payload->LParam = slot->LParam;
+
+    MemoryBarrier();
+
+    return InterlockedCompareExchange(&slot->PayloadIndex, 0, 0) == payloadIndex;
+}
+
+PumpData* GetPumpData(int threadId)
+{
+    int index = FindThreadDataIndex(threadId);
+
+    if (index == -1)
+        return nullptr;
+
+    return &SharedData[index].Pump;
+}
+
+void RecordPumpActivity(PumpData* pumpData, bool removed)
+{
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+
+    // Only the hooked thread ever records its own activity, so we need atomicity here only to keep readers in other
+    // processes from seeing torn values.
+    if (pumpData->ProbeResponseTime < pumpData->LastProbeTime)
+        InterlockedExchange64(&pumpData->ProbeResponseTime, now.QuadPart);
+
+    InterlockedExchange64(&pumpData->LastPumpTime, now.QuadPart);
+
+    if (removed)
+        InterlockedIncrement(&pumpData->RetrievalCount);
+    else
+        InterlockedIncrement(&pumpData->PeekCount);
 }
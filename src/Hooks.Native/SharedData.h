@@ -25,9 +25,41 @@ struct HookData
 	 */
 	HHOOK Handle;
 	/**
-	 * A handle to the window that hook messages will be sent to.
+	 * Handles to the windows that hook messages will be sent to.
 	 */
-	HWND Destination;
+	HWND Destinations[MaxDestinations];
+	/**
+	 * The number of windows that hook messages are distributed across.
+	 */
+	int DestinationCount;
+	/**
+	 * The policy that determines which destination window a particular hook message is sent to.
+	 */
+	ShardingPolicy Sharding;
+	/**
+	 * The number of hook messages distributed in a round-robin fashion so far.
+	 */
+	LONG RoundRobinCount;
+	/**
+	 * Options that alter the behavior of the hook procedure.
+	 */
+	HookOptions Options;
+	/**
+	 * The sequence number of the last event captured by a low-level input hook procedure.
+	 */
+	LONG EventSequence;
+	/**
+	 * The number of events a low-level input hook procedure captured but failed to deliver to its destination.
+	 */
+	LONG DroppedEventCount;
+	/**
+	 * The identifier of the process that installed the hook procedure.
+	 */
+	DWORD OwnerProcessId;
+	/**
+	 * A token identifying the owner of the hook procedure within the process that installed it.
+	 */
+	int Owner;
 };
 
 /**
@@ -67,6 +99,38 @@ struct ThreadData
 	 * The installed \c WH_MOUSE_LL hook procedure for the thread, if one exists.
 	 */
 	HookData LowLevelMouseHook;
+	/**
+	 * Message pump activity recorded by the thread's \c WH_GETMESSAGE hook procedure, if one exists.
+	 */
+	PumpData Pump;
+};
+
+/**
+ * Represents a slot in shared memory holding the message parameters of a hook event until its destination reads them.
+ */
+struct HookEventSlot
+{
+	/**
+	 * The payload index of the hook event whose parameters are held in the slot, or zero while they are being written.
+	 */
+	LONG PayloadIndex;
+	/**
+	 * Additional message-specific information.
+	 */
+	WPARAM WParam;  // NOLINT(clang-diagnostic-padded) Compiler will do the padding for us.
+	/**
+	 * Additional message-specific information.
+	 */
+	LPARAM LParam;
+	/**
+	 * Value indicating if the destination has changed the message parameters held in the slot, for hook events whose
+	 * messages can be modified.
+	 */
+	LONG Changed;
+	/**
+	 * The message identifier the destination changed the hook event's message to.
+	 */
+	UINT ChangedMessage;
 };
 
 /**
@@ -74,9 +138,23 @@ struct ThreadData
  */
 constexpr int MaxThreads = 20;
 /**
- * The size allocated for the shared memory used to store hook data.
+ * The number of slots in the ring of hook event payloads, which must be a power of two.
+ * @remarks Only sent hook events store their payloads here, so a slot is only reused while its payload is still needed if
+ *			this many hook procedures, across every process, are blocked waiting on their destinations at once. Posted
+ *			hook events carry their parameters inline, as a destination falling behind could otherwise lose them to
+ *			busier hook procedures elsewhere.
+ */
+constexpr int HookEventSlotCount = 16384;
+/**
+ * The size allocated for the shared memory used to store hook data and hook event payloads.
+ */
+constexpr size_t SharedMemorySize = sizeof(ThreadData) * MaxThreads + sizeof(HookEventSlot) * HookEventSlotCount;
+/**
+ * The maximum number of hook procedures that can have hook data associated with them at one time.
  */
-constexpr int SharedMemorySize = 1760;
+constexpr int MaxHookDataCount = MaxThreads * (LowLevelMouse + 1);
+
+static_assert((HookEventSlotCount & (HookEventSlotCount - 1)) == 0, "The hook event slot count must be a power of two.");
 
 /**
  * Initializes various shared memory and synchronization objects used for communication between processes.
@@ -118,32 +196,123 @@ HookData* GetHookData(HookType hookType, int threadId);
 void RemoveHookData(HookType hookType, int threadId);
 
 /**
- * Handle to a mutex used to synchronize write access to any variable in the DLL's shared data segment.
+ * Reserves the hook data for a batch of hook procedure changes in a single update of shared memory.
+ * @param changes The hook procedure changes to reserve hook data for.
+ * @param changeCount The number of changes in \c changes.
+ * @param hookData
+ * An array that receives a pointer to the hook data affected by each change: free hook data associated with the thread being
+ * hooked for an installation, or the existing hook data of the hook procedure for an uninstallation.
+ * @return
+ * True if hook data was reserved for every change; false, with nothing having been reserved, if the limits on shared data storage
+ * would be exceeded, a hook procedure being uninstalled doesn't exist, or a hook procedure being installed already does (and isn't
+ * also being uninstalled by the batch).
+ * @remarks Hook data reserved for an installation is left empty until it is committed with \c CommitHookData.
  */
-extern HANDLE SharedSectionMutex;
+bool ReserveHookData(const HookChange* changes, int changeCount, HookData** hookData);
 
-// Shared data segment variables.
+/**
+ * Commits a batch of applied hook procedure changes to the hook data previously reserved for them, in a single update of shared
+ * memory.
+ * @param changes The hook procedure changes, of which only those marked as having succeeded are committed.
+ * @param changeCount The number of changes in \c changes.
+ * @param hookData The hook data reserved for each change by \c ReserveHookData.
+ * @param installedData The hook data to store for each successful installation.
+ * @remarks Uninstallations are committed before installations, and any thread left without hook data is freed.
+ */
+void CommitHookData(const HookChange* changes, int changeCount, HookData* const* hookData, const HookData* installedData);
 
 /**
- * Value indicating if an intercepted message queue message's parameters have been modified.
+ * Finds the hook procedures installed by the calling process on behalf of the specified owner, and reserves their hook data for
+ * uninstallation in the same update of shared memory.
+ * @param owner The token identifying the owner of the hook procedures.
+ * @param changes An array that receives an uninstallation for each hook procedure found.
+ * @param capacity The number of changes \c changes can hold, which should be \c MaxHookDataCount to be sure to find them all.
+ * @param hookData An array, able to hold \c capacity elements, that receives a pointer to the hook data of each hook procedure found.
+ * @return The number of uninstallations written to \c changes.
+ * @remarks The reserved uninstallations are committed with \c CommitHookData, exactly as those reserved by \c ReserveHookData are.
  */
-extern bool ChangeMessage;
+int ReserveOwnedHookData(int owner, HookChange* changes, int capacity, HookData** hookData);
+
 /**
- * The updated message parameter for a message intercepted from a message queue.
+ * Selects the window a hook message should be sent to according to the hook's sharding policy.
+ * @param hookData The hook data for the hook procedure sending the message.
+ * @param threadId The identifier of the thread that generated the hook message.
+ * @param window A handle to the window associated with the hook message, if there is one.
+ * @return A handle to the window the hook message should be sent to, or a \c nullptr if there are no destinations.
  */
-extern UINT ChangedMessage;
+HWND SelectDestination(HookData* hookData, int threadId, HWND window);
+
 /**
- * The updated wParam parameter for a message intercepted from a message queue.
+ * Stores the message parameters of a hook event in shared memory, where its destination can read them back.
+ * @param wParam Additional message-specific information.
+ * @param lParam Additional message-specific information.
+ * @return The payload index to send to the destination alongside the hook event, which is never zero.
  */
-extern WPARAM ChangedWParam;
+LONG StoreHookEventPayload(WPARAM wParam, LPARAM lParam);
+
 /**
- * The updated lParam parameter for a message intercepted from a message queue.
+ * Changes the message parameters of a hook event in shared memory, on behalf of its destination.
+ * @param payloadIndex The payload index of the hook event being changed.
+ * @param message The message identifier to use.
+ * @param wParam Additional message-specific information to use.
+ * @param lParam Additional message-specific information to use.
+ * @return True if the parameters were changed; false if their slot has since been reused for a later hook event.
  */
-extern LPARAM ChangedLParam;
+bool ChangeHookEventPayload(LONG payloadIndex, UINT message, WPARAM wParam, LPARAM lParam);
+
+/**
+ * Loads the message parameters of a hook event changed by its destination from shared memory.
+ * @param payloadIndex The payload index returned by \c StoreHookEventPayload when the parameters were stored.
+ * @param message A pointer to the variable that receives the changed message identifier.
+ * @param payload A pointer to the variable that receives the changed message parameters.
+ * @return True if the destination changed the parameters; false if it didn't, or their slot has since been reused.
+ */
+bool LoadChangedHookEventPayload(LONG payloadIndex, UINT* message, HookEventPayload* payload);
+
+/**
+ * Loads the message parameters of a hook event from shared memory.
+ * @param payloadIndex The payload index returned by \c StoreHookEventPayload when the parameters were stored.
+ * @param payload A pointer to the variable that receives the message parameters.
+ * @return True if the parameters were loaded; false if their slot has since been reused for a later hook event.
+ */
+bool LoadHookEventPayload(LONG payloadIndex, HookEventPayload* payload);
+
+/**
+ * Retrieves the message pump activity recorded for a thread.
+ * @param threadId The identifier of the thread associated with the message pump activity.
+ * @return A pointer to the thread's message pump activity, if the thread has hook data; otherwise, a \c nullptr.
+ * @remarks Unlike \c GetHookData, this will never fall back to the data of a thread that installed a global hook, as
+ *			message pump activity is only meaningful for the thread that actually performed it.
+ */
+PumpData* GetPumpData(int threadId);
+
+/**
+ * Records the retrieval of a message from a thread's message queue.
+ * @param pumpData The message pump activity for the thread.
+ * @param removed Value indicating if the message was removed from the queue, as opposed to only being examined.
+ */
+void RecordPumpActivity(PumpData* pumpData, bool removed);
+
+/**
+ * Handle to a mutex used to synchronize write access to any variable in the DLL's shared data segment.
+ */
+extern HANDLE SharedSectionMutex;
+
+// Shared data segment variables.
+
 /**
  * The number of threads that currently have hook data associated with them.
  */
 extern int ThreadCount;
+/**
+ * The number of thread slots in shared memory that may have hook data associated with them, which includes any freed slots
+ * lying below the highest one in use.
+ */
+extern int ThreadSlotCount;
+/**
+ * The payload index of the last hook event stored in shared memory.
+ */
+extern LONG HookEventPayloadIndex;
 /**
  * The identifier for the thread that installed a global \c CallWndProc hook procedure.
  */
@@ -155,4 +324,12 @@ extern int GlobalCallWndProcRetId;
 /**
  * The identifier for the thread that installed a global \c GetMessage hook procedure.
  */
-extern int GlobalGetMessageId;
\ No newline at end of file
+extern int GlobalGetMessageId;
+/**
+ * The number of times \c SharedSectionMutex was held by another thread when it needed to be acquired.
+ */
+extern LONGLONG SharedSectionWaitCount;
+/**
+ * The total time, in performance counter ticks, spent waiting for \c SharedSectionMutex while it was held by another thread.
+ */
+extern LONGLONG SharedSectionWaitTicks;
\ No newline at end of file
@@ -0,0 +1,217 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System.Diagnostics;
+using BadEcho.Hooks.Interop;
+
+namespace BadEcho.Hooks;
+
+/// <summary>
+/// Provides a tracker of the delivery latency and loss of events forwarded by a low-level input hook procedure.
+/// </summary>
+/// <remarks>
+/// <para>
+/// Latency is measured from the moment the hook procedure captured an event to the moment its listener received it, and
+/// is recorded in a histogram whose buckets are no wider than a sixteenth of their lower bound, allowing percentiles to be
+/// reported to within about 6%.
+/// </para>
+/// <para>
+/// Every event the hook procedure captures is assigned the next number in its sequence, whether or not it is successfully
+/// delivered, so any number we never see belongs to a lost event. When events are sharded across several listener threads,
+/// an event may arrive after one with a higher sequence number; it is then no longer counted as missing.
+/// </para>
+/// </remarks>
+public sealed class HookEventTracker
+{
+    private const int SUB_BUCKET_BITS = 4;
+    private const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    private const int MAX_EXPONENT = 40;
+    private const int BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKET_COUNT;
+
+    private readonly long[] _latencyCounts = new long[BUCKET_COUNT];
+    private readonly Lock _sequenceLock = new();
+
+    private long _eventCount;
+    private long _missingEventCount;
+    private long _gapCount;
+    private int _lastSequence;
+    private bool _sequenceStarted;
+
+    /// <summary>
+    /// Gets the number of events received.
+    /// </summary>
+    public long EventCount
+        => Interlocked.Read(ref _eventCount);
+
+    /// <summary>
+    /// Gets the number of events whose sequence numbers were skipped and that have not since been received.
+    /// </summary>
+    public long MissingEventCount
+    {
+        get
+        {
+            lock (_sequenceLock)
+            {
+                return _missingEventCount;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Gets the number of times the sequence skipped ahead, each of which indicates one or more missing events.
+    /// </summary>
+    public long GapCount
+    {
+        get
+        {
+            lock (_sequenceLock)
+            {
+                return _gapCount;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Gets the delivery latency at or below which the specified percentage of received events fall.
+    /// </summary>
+    /// <param name="percentile">The percentage of received events, from 0 to 100.</param>
+    /// <returns>
+    /// The upper bound of the histogram bucket containing the specified percentile, or <see cref="TimeSpan.Zero"/> if no
+    /// events have been received.
+    /// </returns>
+    public TimeSpan GetLatencyPercentile(double percentile)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegative(percentile);
+        ArgumentOutOfRangeException.ThrowIfGreaterThan(percentile, 100);
+
+        long[] counts = new long[BUCKET_COUNT];
+        long totalCount = 0;
+
+        for (int i = 0; i < BUCKET_COUNT; i++)
+        {
+            counts[i] = Interlocked.Read(ref _latencyCounts[i]);
+            totalCount += counts[i];
+        }
+
+        if (totalCount == 0)
+            return TimeSpan.Zero;
+
+        long targetCount = Math.Max(1, (long) Math.Ceiling(totalCount * percentile / 100));
+        long cumulativeCount = 0;
+
+        for (int i = 0; i < BUCKET_COUNT; i++)
+        {
+            cumulativeCount += counts[i];
+
+            if (cumulativeCount >= targetCount)
+                return TimeSpan.FromMicroseconds(GetUpperBound(i));
+        }
+
+        return TimeSpan.FromMicroseconds(GetUpperBound(BUCKET_COUNT - 1));
+    }
+
+    /// <summary>
+    /// Discards all recorded latencies and sequence information.
+    /// </summary>
+    public void Reset()
+    {
+        lock (_sequenceLock)
+        {
+            for (int i = 0; i < BUCKET_COUNT; i++)
+            {
+                Interlocked.Exchange(ref _latencyCounts[i], 0);
+            }
+
+            Interlocked.Exchange(ref _eventCount, 0);
+
+            _missingEventCount = 0;
+            _gapCount = 0;
+            _sequenceStarted = false;
+        }
+    }
+
+    /// <summary>
+    /// Records the receipt of a traced event.
+    /// </summary>
+    /// <param name="stamp">The tracing details of the event.</param>
+    internal void Record(EventStamp stamp)
+        => Record(stamp, Stopwatch.GetTimestamp());
+
+    /// <summary>
+    /// Records the receipt of a traced event at a particular time.
+    /// </summary>
+    /// <param name="stamp">The tracing details of the event.</param>
+    /// <param name="receiveTime">The performance counter value at the time the event was received.</param>
+    internal void Record(EventStamp stamp, long receiveTime)
+    {
+        long latency = Math.Max(0, receiveTime - stamp.CaptureTime);
+        long microseconds = (long) ((double) latency * 1_000_000 / Stopwatch.Frequency);
+
+        Interlocked.Increment(ref _latencyCounts[GetBucket(microseconds)]);
+        Interlocked.Increment(ref _eventCount);
+
+        lock (_sequenceLock)
+        {
+            if (!_sequenceStarted)
+            {
+                _lastSequence = stamp.Sequence;
+                _sequenceStarted = true;
+                return;
+            }
+
+            // Sequence numbers are compared by their difference so that the comparison survives them wrapping around.
+            int distance = unchecked(stamp.Sequence - _lastSequence);
+
+            if (distance > 0)
+            {
+                if (distance > 1)
+                {
+                    _gapCount++;
+                    _missingEventCount += distance - 1;
+                }
+
+                _lastSequence = stamp.Sequence;
+            }
+            else if (_missingEventCount > 0)
+            {   // A late arrival, which can only happen when events are sharded, fills in part of an earlier gap.
+                _missingEventCount--;
+            }
+        }
+    }
+
+    private static int GetBucket(long microseconds)
+    {
+        if (microseconds < SUB_BUCKET_COUNT)
+            return (int) microseconds;
+
+        int exponent = 63 - (int) ulong.LeadingZeroCount((ulong) microseconds);
+
+        if (exponent > MAX_EXPONENT)
+            return BUCKET_COUNT - 1;
+
+        int subBucket = (int) (microseconds >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+
+        return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + subBucket;
+    }
+
+    private static long GetUpperBound(int bucket)
+    {
+        if (bucket < SUB_BUCKET_COUNT)
+            return bucket + 1;
+
+        int exponent = bucket / SUB_BUCKET_COUNT + SUB_BUCKET_BITS - 1;
+        int subBucket = bucket % SUB_BUCKET_COUNT;
+
+        return (long) (SUB_BUCKET_COUNT + subBucket + 1) << (exponent - SUB_BUCKET_BITS);
+    }
+}
@@ -24,10 +24,23 @@ namespace BadEcho.Hooks;
 /// </summary>
 public abstract class HookSource : IDisposable, IAsyncDisposable
 {
+    private const int MAX_SHARDS = 8;
+    private const int RAW_INPUT_CAPACITY = 256;
+    private const int MAX_EVENTS_PER_RAW_INPUT = 13;
+    private const int HOOK_EVENT_MESSAGE_SHIFT = 8;
+    private const int HOOK_EVENT_ATTRIBUTES_SHIFT = 24;
+
     private readonly MessageOnlyExecutor _hookExecutor = new();
+    private readonly MessageOnlyExecutor[] _shardExecutors = [];
     private readonly HookType _hookType;
     private readonly int _threadId;
+    private readonly HookOptions _options;
+    private readonly ShardingPolicy _shardingPolicy;
+    private readonly InputCaptureMode _captureMode;
+    private readonly InputEvent[] _rawInputEvents = [];
 
+    private uint _hookEventMessage;
+    private int _unreadPayloadCount;
     private bool _hooked;
     private bool _disposed;
 
@@ -37,9 +50,97 @@ public abstract class HookSource : IDisposable, IAsyncDisposable
     /// <param name="hookType">An enumeration value specifying the type of hook procedure to install.</param>
     /// <param name="threadId">The identifier of the thread with which the hook procedure is to be associated.</param>
     protected HookSource(HookType hookType, int threadId)
+        : this(hookType, threadId, HookOptions.None)
+    { }
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="HookSource"/> class.
+    /// </summary>
+    /// <param name="hookType">An enumeration value specifying the type of hook procedure to install.</param>
+    /// <param name="threadId">The identifier of the thread with which the hook procedure is to be associated.</param>
+    /// <param name="options">An enumeration value specifying options that alter the behavior of the hook procedure.</param>
+    protected HookSource(HookType hookType, int threadId, HookOptions options)
         : this(hookType)
     {
         _threadId = threadId;
+        _options = options;
+    }
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="HookSource"/> class.
+    /// </summary>
+    /// <param name="hookType">An enumeration value specifying the type of hook procedure to install.</param>
+    /// <param name="threadId">The identifier of the thread with which the hook procedure is to be associated.</param>
+    /// <param name="options">An enumeration value specifying options that alter the behavior of the hook procedure.</param>
+    /// <param name="shardCount">
+    /// The number of message loops, each running on its own thread, that hook events will be distributed across.
+    /// </param>
+    /// <param name="shardingPolicy">
+    /// An enumeration value specifying how hook events are distributed across the message loops.
+    /// </param>
+    /// <remarks>
+    /// When using more than one shard, <see cref="OnHookEvent(nint, uint, nint, nint, HookEventAttributes)"/> will be
+    /// called concurrently from multiple threads. Events are only guaranteed to arrive in order relative to other events
+    /// sharing the same key under <c>shardingPolicy</c>.
+    /// </remarks>
+    protected HookSource(HookType hookType, int threadId, HookOptions options, int shardCount, ShardingPolicy shardingPolicy)
+        : this(hookType, threadId, options)
+    {
+        ArgumentOutOfRangeException.ThrowIfLessThan(shardCount, 1);
+        ArgumentOutOfRangeException.ThrowIfGreaterThan(shardCount, MAX_SHARDS);
+
+        _shardExecutors = new MessageOnlyExecutor[shardCount - 1];
+
+        for (int i = 0; i < _shardExecutors.Length; i++)
+        {
+            _shardExecutors[i] = new MessageOnlyExecutor();
+        }
+
+        _shardingPolicy = shardingPolicy;
+    }
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="HookSource"/> class.
+    /// </summary>
+    /// <param name="hookType">An enumeration value specifying the type of hook procedure to install.</param>
+    /// <param name="options">An enumeration value specifying options that alter the behavior of the hook procedure.</param>
+    /// <param name="shardCount">
+    /// The number of message loops, each running on its own thread, that hook events will be distributed across.
+    /// </param>
+    /// <param name="shardingPolicy">
+    /// An enumeration value specifying how hook events are distributed across the message loops.
+    /// </param>
+    /// <remarks>
+    /// This will result in the hook procedure being installed as a global hook. When using more than one shard,
+    /// <see cref="OnHookEvent(nint, uint, nint, nint, HookEventAttributes)"/> will be called concurrently from multiple threads.
+    /// </remarks>
+    protected HookSource(HookType hookType, HookOptions options, int shardCount, ShardingPolicy shardingPolicy)
+        : this(hookType, 0, options, shardCount, shardingPolicy)
+    { }
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="HookSource"/> class.
+    /// </summary>
+    /// <param name="hookType">An enumeration value specifying the type of hook procedure to install.</param>
+    /// <param name="captureMode">An enumeration value specifying the mechanism used to capture input events.</param>
+    /// <remarks>
+    /// This will result in the hook procedure being installed as a global hook, unless <c>captureMode</c> specifies that
+    /// raw input is to be used instead, which is only supported for <see cref="HookType.LowLevelKeyboard"/> and
+    /// <see cref="HookType.LowLevelMouse"/> hook types. Raw input is delivered to
+    /// <see cref="OnHookEvent(nint, uint, nint, nint, HookEventAttributes)"/> in exactly the same form as the messages of
+    /// the hook procedure it replaces.
+    /// </remarks>
+    protected HookSource(HookType hookType, InputCaptureMode captureMode)
+        : this(hookType)
+    {
+        if (captureMode != InputCaptureMode.RawInput)
+            return;
+
+        if (hookType is not (HookType.LowLevelKeyboard or HookType.LowLevelMouse))
+            throw new ArgumentException(Strings.RawInputRequiresLowLevelHookType, nameof(captureMode));
+
+        _captureMode = captureMode;
+        _rawInputEvents = new InputEvent[RAW_INPUT_CAPACITY];
     }
 
     /// <summary>
@@ -55,6 +156,44 @@ public abstract class HookSource : IDisposable, IAsyncDisposable
         _hookType = hookType;
     }
 
+    /// <summary>
+    /// Gets a value indicating if events captured by a low-level input hook procedure are stamped with their sequence
+    /// number and capture time, so that their delivery latency and loss can be tracked.
+    /// </summary>
+    /// <remarks>
+    /// This only applies to <see cref="HookType.LowLevelKeyboard"/> and <see cref="HookType.LowLevelMouse"/> hook
+    /// procedures, and must be set before the hook procedure is installed. Traced events are recorded by
+    /// <see cref="Tracker"/> before being passed to <see cref="OnHookEvent(nint, uint, nint, nint, HookEventAttributes)"/>.
+    /// </remarks>
+    public bool TraceEvents
+    { get; init; }
+
+    /// <summary>
+    /// Gets the tracker of the delivery latency and loss of events, when <see cref="TraceEvents"/> is enabled.
+    /// </summary>
+    public HookEventTracker Tracker
+    { get; } = new();
+
+    /// <summary>
+    /// Gets the number of events a low-level input hook procedure captured but failed to deliver to us, typically because
+    /// our message queue was full, along with any events whose message parameters could no longer be read once received.
+    /// </summary>
+    public int DroppedEventCount
+    {
+        get
+        {
+            int unreadPayloadCount = Volatile.Read(ref _unreadPayloadCount);
+
+            // The hook data of a global hook procedure is found by the thread that installed it, which is our message pump's.
+            if (_threadId != 0)
+                return ReadDroppedEventCount() + unreadPayloadCount;
+
+            return _hookExecutor.Window != null
+                ? _hookExecutor.Invoke(ReadDroppedEventCount) + unreadPayloadCount
+                : unreadPayloadCount;
+        }
+    }
+
     /// <summary>
     /// Initializes the message loop that facilitates the receiving of hook messages, and then installs the hook procedure.
     /// </summary>
@@ -65,10 +204,17 @@ public abstract class HookSource : IDisposable, IAsyncDisposable
         {
             await _hookExecutor.StartAsync().ConfigureAwait(false);
 
-            if (_hookExecutor.Window == null)
+            _hookEventMessage = Native.GetHookEventMessage();
+
+            if (_hookExecutor.Window == null || _hookEventMessage == 0)
                 throw new InvalidOperationException(Strings.MessagingForHookFailed);
 
             _hookExecutor.Window.AddCallback(HandleHookEvent);
+
+            foreach (MessageOnlyExecutor shardExecutor in _shardExecutors)
+            {
+                await StartShardAsync(shardExecutor).ConfigureAwait(false);
+            }
         }
 
         if (_hooked)
@@ -77,11 +223,34 @@ public abstract class HookSource : IDisposable, IAsyncDisposable
         // Some hook procedures, when installed at a global scope, are called in the context of the thread that installed them.
         // This sort of voodoo requires said thread to be pumping a message loop. So, to cover all possible cases, we make sure
         // to install the hook procedure using the local message-only window thread.
+        HookOptions options = TraceEvents ? _options | HookOptions.TraceEvents : _options;
+
         await _hookExecutor.InvokeAsync(() =>
-        {
-            _hooked = Native.AddHook(_hookType,
-                                     _hookExecutor.Window.Handle, 
-                                     _threadId);
+        {   // Raw input is likewise only delivered to the thread owning the window registered for it.
+            if (_captureMode == InputCaptureMode.RawInput)
+            {
+                _hooked = Native.RegisterRawInput(_hookType, _hookExecutor.Window.Handle);
+                return;
+            }
+
+            if (_shardExecutors.Length == 0)
+            {
+                _hooked = Native.AddHook(_hookType,
+                                         _hookExecutor.Window.Handle,
+                                         _threadId,
+                                         options);
+                return;
+            }
+
+            IntPtr[] destinations = [_hookExecutor.Window.Handle.DangerousGetHandle(),
+                                     .._shardExecutors.Select(e => e.Window!.Handle.DangerousGetHandle())];
+
+            _hooked = Native.AddShardedHook(_hookType,
+                                            destinations,
+                                            destinations.Length,
+                                            _shardingPolicy,
+                                            _threadId,
+                                            options);
         });
     }
 
@@ -126,7 +295,7 @@ public abstract class HookSource : IDisposable, IAsyncDisposable
             return;
 
         await StopAsync().ConfigureAwait(false);
-        _hookExecutor.Dispose();
+        DisposeExecutors();
         
         _disposed = true;
     }
@@ -145,7 +314,7 @@ public abstract class HookSource : IDisposable, IAsyncDisposable
         if (disposing)
         {
             RemoveHook();
-            _hookExecutor.Dispose();
+            DisposeExecutors();
         }
 
         _disposed = true;
@@ -160,27 +329,127 @@ public abstract class HookSource : IDisposable, IAsyncDisposable
     /// <param name="lParam">Additional message-specific information.</param>
     protected abstract void OnHookEvent(nint hWnd, uint msg, nint wParam, nint lParam);
 
+    /// <summary>
+    /// Called by the installed native hook procedure via <c>SendMessage</c>/<c>PostMessage</c> when a hook event has occurred,
+    /// along with additional information about the event.
+    /// </summary>
+    /// <param name="hWnd">A handle to the window.</param>
+    /// <param name="msg">The message.</param>
+    /// <param name="wParam">Additional message-specific information.</param>
+    /// <param name="lParam">Additional message-specific information.</param>
+    /// <param name="attributes">An enumeration value specifying additional information about the hook event.</param>
+    /// <remarks>
+    /// By default, this ignores <c>attributes</c> and calls <see cref="OnHookEvent(nint, uint, nint, nint)"/>. Sources whose
+    /// hook procedures report additional information should override this instead.
+    /// </remarks>
+    protected virtual void OnHookEvent(nint hWnd, uint msg, nint wParam, nint lParam, HookEventAttributes attributes)
+        => OnHookEvent(hWnd, msg, wParam, lParam);
+
     private ProcedureResult HandleHookEvent(IntPtr hWnd, uint msg, IntPtr wParam, IntPtr lParam)
-    {   // Ignore all system messages; we're only interested in messages sent by our hook DLL.
-        if (msg < (int) WindowMessage.User)
+    {
+        if (msg == _hookEventMessage)
+        {
+            DispatchHookEvent(hWnd, wParam, lParam);
+
+            // We always mark our hook messages as handled; we don't want further processing by any supporting
+            // infrastructure. This has no bearing on whether or not the next hook procedure in the current hook
+            // chain is called, which our hook DLL will always do.
             return new ProcedureResult(IntPtr.Zero, true);
+        }
 
-        msg -= (int) WindowMessage.User;
+        if (msg == (int) WindowMessage.Input && _captureMode == InputCaptureMode.RawInput)
+        {
+            ReadRawInput(hWnd, lParam);
 
-        OnHookEvent(hWnd, msg, wParam, lParam);
+            // Raw input messages must go on to the default window procedure so the system can clean up after them.
+            return new ProcedureResult(IntPtr.Zero, false);
+        }
 
-        // We always mark our hook messages as handled; we don't want further processing by any supporting
-        // infrastructure. This has no bearing on whether or not the next hook procedure in the current hook
-        // chain is called, which our hook DLL will always do.
+        // Ignore all system messages; we're only interested in messages sent by our hook DLL.
         return new ProcedureResult(IntPtr.Zero, true);
     }
 
+    private void DispatchHookEvent(IntPtr hWnd, IntPtr header, IntPtr payloadIndex)
+    {   // The header packs the intercepted message identifier and the event's attributes above the type of hook procedure
+        // that sent it.
+        var hookType = (HookType) (header & 0xFF);
+        var msg = (uint) ((header >> HOOK_EVENT_MESSAGE_SHIFT) & 0xFFFF);
+        var attributes = (HookEventAttributes) ((header >> HOOK_EVENT_ATTRIBUTES_SHIFT) & 0xFF);
+
+        // Only events from our own hook procedure are handled; those of any other are dropped without reaching OnHookEvent.
+        if (hookType != _hookType)
+            return;
+
+        // A payload is only ever lost if thousands of other hook procedures were waiting on their destinations while this
+        // event was being sent. The event can't be handled without it, so it's counted as dropped rather than delivered.
+        bool payloadRead = Native.ReadHookEventPayload(header, payloadIndex, out HookEventPayload payload);
+
+        // Stamps are queued in the same order as their messages, so one must be read for every message received, even
+        // those whose events are dropped.
+        if (TraceEvents && Native.ReadEventStamp(_hookType, hWnd, out EventStamp stamp) && payloadRead)
+            Tracker.Record(stamp);
+
+        if (!payloadRead)
+        {
+            Interlocked.Increment(ref _unreadPayloadCount);
+            return;
+        }
+
+        OnHookEvent(hWnd, msg, payload.WParam, payload.LParam, attributes);
+    }
+
+    private void ReadRawInput(IntPtr hWnd, IntPtr input)
+    {
+        int count;
+
+        // Raw input is read in bulk, so a single WM_INPUT message may deliver every input event queued since the last one.
+        // A read that comes close to filling our buffer may have left raw input behind for the next read.
+        do
+        {
+            count = Native.ReadRawInput(input, _rawInputEvents, _rawInputEvents.Length);
+
+            for (int i = 0; i < count; i++)
+            {
+                InputEvent inputEvent = _rawInputEvents[i];
+
+                OnHookEvent(hWnd, inputEvent.Message, inputEvent.WParam, inputEvent.LParam, HookEventAttributes.None);
+            }
+
+            input = IntPtr.Zero;
+        } while (count > _rawInputEvents.Length - MAX_EVENTS_PER_RAW_INPUT);
+    }
+
+    private async Task StartShardAsync(MessageOnlyExecutor shardExecutor)
+    {
+        await shardExecutor.StartAsync().ConfigureAwait(false);
+
+        if (shardExecutor.Window == null)
+            throw new InvalidOperationException(Strings.MessagingForHookFailed);
+
+        shardExecutor.Window.AddCallback(HandleHookEvent);
+    }
+
+    private void DisposeExecutors()
+    {
+        _hookExecutor.Dispose();
+
+        foreach (MessageOnlyExecutor shardExecutor in _shardExecutors)
+        {
+            shardExecutor.Dispose();
+        }
+    }
+
+    private int ReadDroppedEventCount()
+        => Native.GetDroppedEventCount(_hookType, _threadId, out int droppedEventCount) ? droppedEventCount : 0;
+
     private void RemoveHook()
     {
         if (!_hooked)
             return;
 
-        _hooked = !Native.RemoveHook(_hookType, _threadId);
+        _hooked = _captureMode == InputCaptureMode.RawInput
+            ? !Native.UnregisterRawInput(_hookType)
+            : !Native.RemoveHook(_hookType, _threadId);
 
         if (_hooked)
             Logger.Warning(Strings.UnhookFailed.InvariantFormat(_threadId));
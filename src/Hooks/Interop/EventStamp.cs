@@ -0,0 +1,37 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System.Runtime.InteropServices;
+
+namespace BadEcho.Hooks.Interop;
+
+/// <summary>
+/// Represents the tracing details of an event forwarded by a low-level input hook procedure.
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+internal struct EventStamp
+{
+    /// <summary>
+    /// The event's sequence number, which increases by one with every event the hook procedure captures, including those
+    /// it then fails to deliver.
+    /// </summary>
+    public int Sequence;
+    /// <summary>
+    /// The time stamp, in milliseconds, the system assigned to the input.
+    /// </summary>
+    public uint Time;
+    /// <summary>
+    /// The performance counter value at the time the hook procedure captured the event.
+    /// </summary>
+    public long CaptureTime;
+}
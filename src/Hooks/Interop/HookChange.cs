@@ -0,0 +1,80 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System.Runtime.InteropServices;
+
+namespace BadEcho.Hooks.Interop;
+
+/// <summary>
+/// Represents a single hook procedure installation or uninstallation within a batch of changes.
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+internal struct HookChange
+{
+    private byte _hookType;
+    private HookChangeAction _action;
+    private byte _options;
+    private byte _succeeded;
+    private int _threadId;
+    private IntPtr _destination;
+
+    /// <summary>
+    /// Gets the type of hook procedure to change.
+    /// </summary>
+    public readonly HookType HookType
+        => (HookType) _hookType;
+
+    /// <summary>
+    /// Gets the identifier of the thread the hook procedure is associated with.
+    /// </summary>
+    public readonly int ThreadId
+        => _threadId;
+
+    /// <summary>
+    /// Gets a value indicating if the change was applied.
+    /// </summary>
+    public readonly bool Succeeded
+        => _succeeded != 0;
+
+    /// <summary>
+    /// Creates a change that installs a hook procedure into a thread.
+    /// </summary>
+    /// <param name="hookType">The type of hook procedure to install.</param>
+    /// <param name="destination">A handle to the window that will receive messages sent to the hook procedure.</param>
+    /// <param name="threadId">The identifier of the thread with which the hook procedure is to be associated.</param>
+    /// <param name="options">Options that alter the behavior of the hook procedure.</param>
+    /// <returns>A <see cref="HookChange"/> value that installs the hook procedure.</returns>
+    public static HookChange Install(HookType hookType, IntPtr destination, int threadId, HookOptions options)
+        => new()
+           {
+               _hookType = (byte) hookType,
+               _action = HookChangeAction.Install,
+               _options = (byte) options,
+               _threadId = threadId,
+               _destination = destination
+           };
+
+    /// <summary>
+    /// Creates a change that uninstalls a hook procedure from a thread.
+    /// </summary>
+    /// <param name="hookType">The type of hook procedure to uninstall.</param>
+    /// <param name="threadId">The identifier of the thread to remove the hook procedure from.</param>
+    /// <returns>A <see cref="HookChange"/> value that uninstalls the hook procedure.</returns>
+    public static HookChange Uninstall(HookType hookType, int threadId)
+        => new()
+           {
+               _hookType = (byte) hookType,
+               _action = HookChangeAction.Uninstall,
+               _threadId = threadId
+           };
+}
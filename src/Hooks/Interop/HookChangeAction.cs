@@ -0,0 +1,29 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace BadEcho.Hooks.Interop;
+
+/// <summary>
+/// Specifies a change to make to the set of installed hook procedures.
+/// </summary>
+internal enum HookChangeAction : byte
+{
+    /// <summary>
+    /// A hook procedure is installed into a thread.
+    /// </summary>
+    Install,
+    /// <summary>
+    /// A hook procedure is uninstalled from a thread.
+    /// </summary>
+    Uninstall
+}
@@ -0,0 +1,31 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace BadEcho.Hooks.Interop;
+
+/// <summary>
+/// Specifies additional information about a hook event, as reported by the hook procedure that sent it.
+/// </summary>
+[Flags]
+public enum HookEventAttributes
+{
+    /// <summary>
+    /// The hook event has no additional information.
+    /// </summary>
+    None = 0x0,
+    /// <summary>
+    /// The message queue message is only being examined by <c>PeekMessage</c> with <c>PM_NOREMOVE</c>, rather than being
+    /// removed from the queue, and so its details cannot be changed.
+    /// </summary>
+    Peeked = 0x1
+}
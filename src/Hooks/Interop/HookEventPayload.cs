@@ -0,0 +1,33 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System.Runtime.InteropServices;
+
+namespace BadEcho.Hooks.Interop;
+
+/// <summary>
+/// Represents the message parameters of a hook event, which travel either through shared memory or, for low-level hook
+/// events, packed into the hook event message alongside its header.
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+internal struct HookEventPayload
+{
+    /// <summary>
+    /// Additional message-specific information.
+    /// </summary>
+    public nint WParam;
+    /// <summary>
+    /// Additional message-specific information.
+    /// </summary>
+    public nint LParam;
+}
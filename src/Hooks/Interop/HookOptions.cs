@@ -0,0 +1,41 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace BadEcho.Hooks.Interop;
+
+/// <summary>
+/// Specifies options that alter the behavior of an installed hook procedure.
+/// </summary>
+[Flags]
+public enum HookOptions
+{
+    /// <summary>
+    /// The hook procedure forwards all hook events to its destination window.
+    /// </summary>
+    None = 0x0,
+    /// <summary>
+    /// The <c>WH_GETMESSAGE</c> hook procedure only records message pump activity for the hooked thread, forwarding
+    /// nothing to its destination window.
+    /// </summary>
+    HeartbeatOnly = 0x1,
+    /// <summary>
+    /// The <c>WH_GETMESSAGE</c> hook procedure forwards messages that are only being examined by <c>PeekMessage</c> with
+    /// <c>PM_NOREMOVE</c>, in addition to messages being removed from the queue.
+    /// </summary>
+    ObservePeeks = 0x2,
+    /// <summary>
+    /// The <c>WH_KEYBOARD_LL</c> and <c>WH_MOUSE_LL</c> hook procedures stamp every event they forward with its sequence
+    /// number and capture time.
+    /// </summary>
+    TraceEvents = 0x4
+}
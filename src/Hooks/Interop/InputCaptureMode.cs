@@ -0,0 +1,36 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace BadEcho.Hooks.Interop;
+
+/// <summary>
+/// Specifies the mechanism used to capture input events for the low-level keyboard and mouse hook types.
+/// </summary>
+public enum InputCaptureMode
+{
+    /// <summary>
+    /// Input events are captured by a <c>WH_KEYBOARD_LL</c> or <c>WH_MOUSE_LL</c> hook procedure, which the system calls
+    /// synchronously as part of its input processing.
+    /// </summary>
+    Hook,
+    /// <summary>
+    /// Input events are captured by registering for raw input, which the system delivers asynchronously to the listener's
+    /// message queue where it is read in bulk.
+    /// </summary>
+    /// <remarks>
+    /// This adds no latency to the input processing of other applications, at the cost of only being able to observe input.
+    /// Raw input registrations are process-wide, so only one source per process can capture a particular type of input
+    /// this way.
+    /// </remarks>
+    RawInput
+}
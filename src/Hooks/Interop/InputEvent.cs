@@ -0,0 +1,36 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System.Runtime.InteropServices;
+
+namespace BadEcho.Hooks.Interop;
+
+/// <summary>
+/// Represents an input event in the same form that a low-level input hook procedure sends it to its listener.
+/// </summary>
+[StructLayout(LayoutKind.Sequential)]
+internal struct InputEvent
+{
+    /// <summary>
+    /// The input message.
+    /// </summary>
+    public uint Message;
+    /// <summary>
+    /// Additional message-specific information.
+    /// </summary>
+    public nint WParam;
+    /// <summary>
+    /// Additional message-specific information.
+    /// </summary>
+    public nint LParam;
+}
@@ -0,0 +1,34 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+using BadEcho.Interop;
+
+namespace BadEcho.Hooks.Interop;
+
+/// <summary>
+/// Represents a callback that processes keyboard input messages along with the keyboard's modifier and lock key states.
+/// </summary>
+/// <param name="state">An enumeration value specifying the state of the key.</param>
+/// <param name="key">An enumeration value specifying the key that generated the message.</param>
+/// <param name="modifiers">
+/// An enumeration value specifying the modifier keys being held, including <c>key</c> itself if it's a modifier key.
+/// </param>
+/// <param name="lockKeys">
+/// An enumeration value specifying the lock keys toggled on, including <c>key</c> itself if it's a lock key.
+/// </param>
+/// <returns>The result of processing the keyboard input message.</returns>
+/// <remarks>
+/// The modifier and lock key states are maintained by the hook procedure from the keyboard input it sees, and reflect the
+/// state of the keyboard exactly as of the event, without any need for additional key state queries.
+/// </remarks>
+public delegate ProcedureResult KeyboardInputProcedure(KeyState state, VirtualKey key, ModifierKeys modifiers, LockKeys lockKeys);
@@ -30,12 +30,34 @@ internal static partial class Native
     /// <param name="hookType">The type of hook procedure to install.</param>
     /// <param name="destination">A handle to the window that will receive messages sent to the hook procedure.</param>
     /// <param name="threadId">The identifier of the thread with which the hook procedure is to be associated.</param>
+    /// <param name="options">Options that alter the behavior of the hook procedure.</param>
     /// <returns>True if successful; otherwise, false.</returns>
     [LibraryImport(LIBRARY_NAME, SetLastError = true)]
     [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
     [return: MarshalAs(UnmanagedType.U1)]
     [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
-    public static partial bool AddHook(HookType hookType, WindowHandle destination, int threadId);
+    public static partial bool AddHook(HookType hookType, WindowHandle destination, int threadId, HookOptions options);
+
+    /// <summary>
+    /// Installs a new Win32 hook procedure into the specified thread, distributing its events across several windows.
+    /// </summary>
+    /// <param name="hookType">The type of hook procedure to install.</param>
+    /// <param name="destinations">Handles to the windows that will receive messages sent to the hook procedure.</param>
+    /// <param name="destinationCount">The number of handles in <c>destinations</c>.</param>
+    /// <param name="policy">The policy that determines which destination window a particular hook event is sent to.</param>
+    /// <param name="threadId">The identifier of the thread with which the hook procedure is to be associated.</param>
+    /// <param name="options">Options that alter the behavior of the hook procedure.</param>
+    /// <returns>True if successful; otherwise, false.</returns>
+    [LibraryImport(LIBRARY_NAME, SetLastError = true)]
+    [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
+    [return: MarshalAs(UnmanagedType.U1)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
+    public static partial bool AddShardedHook(HookType hookType,
+                                              IntPtr[] destinations,
+                                              int destinationCount,
+                                              ShardingPolicy policy,
+                                              int threadId,
+                                              HookOptions options);
 
     /// <summary>
     /// Uninstalls a Win32 hook procedure from the specified thread.
@@ -49,6 +71,56 @@ internal static partial class Native
     [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
     public static partial bool RemoveHook(HookType hookType, int threadId);
 
+    /// <summary>
+    /// Applies a batch of Win32 hook procedure installations and uninstallations as a single transaction.
+    /// </summary>
+    /// <param name="changes">The changes to apply, each of which is updated to indicate if it was applied.</param>
+    /// <param name="changeCount">The number of changes in <c>changes</c>.</param>
+    /// <param name="owner">
+    /// A token identifying the owner of the hook procedures being installed, for later use with <see cref="RemoveOwnedHooks"/>.
+    /// </param>
+    /// <returns>True if every change was applied; otherwise, false.</returns>
+    [LibraryImport(LIBRARY_NAME, SetLastError = true)]
+    [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
+    [return: MarshalAs(UnmanagedType.U1)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
+    public static partial bool ApplyHookChanges([In, Out] HookChange[] changes, int changeCount, int owner);
+
+    /// <summary>
+    /// Uninstalls every Win32 hook procedure installed by the calling process on behalf of the specified owner.
+    /// </summary>
+    /// <param name="owner">
+    /// The token identifying the owner of the hook procedures, which is zero for those installed with <see cref="AddHook"/>
+    /// or <see cref="AddShardedHook"/>.
+    /// </param>
+    /// <returns>The number of hook procedures uninstalled.</returns>
+    [LibraryImport(LIBRARY_NAME, SetLastError = true)]
+    [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
+    public static partial int RemoveOwnedHooks(int owner);
+
+    /// <summary>
+    /// Retrieves the identifier of the registered message that hook procedures send their events to destination windows with.
+    /// </summary>
+    /// <returns>The identifier of the hook event message, or zero if it could not be registered.</returns>
+    [LibraryImport(LIBRARY_NAME)]
+    [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
+    public static partial uint GetHookEventMessage();
+
+    /// <summary>
+    /// Reads the message parameters of a hook event received by a destination window.
+    /// </summary>
+    /// <param name="header">The header of the hook event, provided by the hook event message's <c>wParam</c>.</param>
+    /// <param name="payloadIndex">The hook event's payload, provided by the hook event message's <c>lParam</c>.</param>
+    /// <param name="payload">The hook event's message parameters.</param>
+    /// <returns>True if the payload was read; false if it has since been overwritten by the payloads of later hook events.</returns>
+    [LibraryImport(LIBRARY_NAME)]
+    [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
+    [return: MarshalAs(UnmanagedType.U1)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
+    public static partial bool ReadHookEventPayload(IntPtr header, IntPtr payloadIndex, out HookEventPayload payload);
+
     /// <summary>
     /// Changes the details of a hook message currently being intercepted.
     /// </summary>
@@ -59,4 +131,106 @@ internal static partial class Native
     [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
     [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
     public static partial void ChangeMessageDetails(uint message, IntPtr wParam, IntPtr lParam);
+
+    /// <summary>
+    /// Retrieves the message pump activity recorded for a thread with an installed <c>WH_GETMESSAGE</c> hook procedure.
+    /// </summary>
+    /// <param name="threadId">The identifier of the thread to retrieve message pump activity for.</param>
+    /// <param name="pumpData">The message pump activity recorded for the thread.</param>
+    /// <returns>True if activity is being recorded for the thread; otherwise, false.</returns>
+    [LibraryImport(LIBRARY_NAME)]
+    [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
+    [return: MarshalAs(UnmanagedType.U1)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
+    public static partial bool GetMessagePumpData(int threadId, out PumpData pumpData);
+
+    /// <summary>
+    /// Retrieves the contention for the mutex guarding the shared hook registry, accumulated across all processes since
+    /// the registry was first created.
+    /// </summary>
+    /// <param name="contention">The contention for the mutex.</param>
+    /// <returns>True if the contention was retrieved; otherwise, false.</returns>
+    [LibraryImport(LIBRARY_NAME)]
+    [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
+    [return: MarshalAs(UnmanagedType.U1)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
+    public static partial bool GetRegistryContention(out RegistryContention contention);
+
+    /// <summary>
+    /// Probes the responsiveness of a thread's message pump by posting a <c>WM_NULL</c> message to its queue.
+    /// </summary>
+    /// <param name="threadId">The identifier of the thread to probe.</param>
+    /// <returns>True if successful; otherwise, false.</returns>
+    [LibraryImport(LIBRARY_NAME, SetLastError = true)]
+    [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
+    [return: MarshalAs(UnmanagedType.U1)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
+    public static partial bool ProbeMessagePump(int threadId);
+
+    /// <summary>
+    /// Reads the tracing details of the oldest hook message received by a destination window from a low-level input hook
+    /// procedure installed with the <see cref="HookOptions.TraceEvents"/> option.
+    /// </summary>
+    /// <param name="hookType">The type of low-level hook procedure that sent the message.</param>
+    /// <param name="destination">A handle to the window that received the message.</param>
+    /// <param name="stamp">The tracing details of the message.</param>
+    /// <returns>True if a stamp was read; otherwise, false.</returns>
+    [LibraryImport(LIBRARY_NAME)]
+    [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
+    [return: MarshalAs(UnmanagedType.U1)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
+    public static partial bool ReadEventStamp(HookType hookType, IntPtr destination, out EventStamp stamp);
+
+    /// <summary>
+    /// Retrieves the number of events a low-level input hook procedure captured but failed to deliver to its destination.
+    /// </summary>
+    /// <param name="hookType">The type of low-level hook procedure.</param>
+    /// <param name="threadId">The identifier of the thread the hook procedure is associated with.</param>
+    /// <param name="droppedEventCount">The number of events dropped.</param>
+    /// <returns>True if the hook procedure is installed; otherwise, false.</returns>
+    [LibraryImport(LIBRARY_NAME)]
+    [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
+    [return: MarshalAs(UnmanagedType.U1)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
+    public static partial bool GetDroppedEventCount(HookType hookType, int threadId, out int droppedEventCount);
+
+    /// <summary>
+    /// Registers a window to receive raw input from all keyboards or mice, as a lower overhead alternative to installing a
+    /// low-level input hook procedure.
+    /// </summary>
+    /// <param name="hookType">The type of low-level hook procedure whose input is to be captured.</param>
+    /// <param name="destination">A handle to the window that will receive <c>WM_INPUT</c> messages.</param>
+    /// <returns>True if successful; otherwise, false.</returns>
+    [LibraryImport(LIBRARY_NAME, SetLastError = true)]
+    [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
+    [return: MarshalAs(UnmanagedType.U1)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
+    public static partial bool RegisterRawInput(HookType hookType, WindowHandle destination);
+
+    /// <summary>
+    /// Stops the delivery of raw input from all keyboards or mice to the window registered for it.
+    /// </summary>
+    /// <param name="hookType">The type of low-level hook procedure whose input is being captured.</param>
+    /// <returns>True if successful; otherwise, false.</returns>
+    [LibraryImport(LIBRARY_NAME, SetLastError = true)]
+    [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
+    [return: MarshalAs(UnmanagedType.U1)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
+    public static partial bool UnregisterRawInput(HookType hookType);
+
+    /// <summary>
+    /// Reads raw input queued for the calling thread in bulk, translating it into the input events that the low-level
+    /// keyboard and mouse hook procedures send to their listeners.
+    /// </summary>
+    /// <param name="input">
+    /// A handle to the raw input provided by the <c>WM_INPUT</c> message currently being processed, or
+    /// <see cref="IntPtr.Zero"/> if the thread's queued raw input is to be read without one.
+    /// </param>
+    /// <param name="events">An array that receives the translated input events.</param>
+    /// <param name="capacity">The number of input events <c>events</c> can hold, which must be at least 13.</param>
+    /// <returns>The number of input events written to <c>events</c>, or -1 if <c>capacity</c> is too small.</returns>
+    [LibraryImport(LIBRARY_NAME)]
+    [UnmanagedCallConv(CallConvs = [typeof(CallConvCdecl)])]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.SafeDirectories)]
+    public static partial int ReadRawInput(IntPtr input, [Out] InputEvent[] events, int capacity);
 }
@@ -0,0 +1,31 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+using BadEcho.Interop;
+
+namespace BadEcho.Hooks.Interop;
+
+/// <summary>
+/// Represents a callback that processes messages being examined, but not removed, from a message queue.
+/// </summary>
+/// <param name="msg">The message.</param>
+/// <param name="wParam">Additional message-specific information.</param>
+/// <param name="lParam">Additional message-specific information.</param>
+/// <returns>
+/// The result of the message processing, which of course depends on the type of message being processed.
+/// </returns>
+/// <remarks>
+/// Unlike <see cref="GetMessageProcedure"/>, this callback cannot modify the message, as it remains in the queue and will be
+/// seen again when the requesting application gets around to removing it.
+/// </remarks>
+public delegate ProcedureResult PeekMessageProcedure(uint msg, nint wParam, nint lParam);
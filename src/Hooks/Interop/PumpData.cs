@@ -0,0 +1,47 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System.Runtime.InteropServices;
+
+namespace BadEcho.Hooks.Interop;
+
+/// <summary>
+/// Represents message pump activity recorded for a thread by its <c>WH_GETMESSAGE</c> hook procedure.
+/// </summary>
+/// <remarks>
+/// All times are performance counter values, which are directly comparable to <see cref="System.Diagnostics.Stopwatch.GetTimestamp"/>.
+/// </remarks>
+[StructLayout(LayoutKind.Sequential)]
+internal struct PumpData
+{
+    /// <summary>
+    /// The time at which the thread last retrieved a message from its queue.
+    /// </summary>
+    public long LastPumpTime;
+    /// <summary>
+    /// The time at which the thread was last probed for responsiveness.
+    /// </summary>
+    public long LastProbeTime;
+    /// <summary>
+    /// The time at which the thread first retrieved a message after it was last probed.
+    /// </summary>
+    public long ProbeResponseTime;
+    /// <summary>
+    /// The number of messages removed from the thread's queue.
+    /// </summary>
+    public int RetrievalCount;
+    /// <summary>
+    /// The number of times a message was examined, but not removed, from the thread's queue.
+    /// </summary>
+    public int PeekCount;
+}
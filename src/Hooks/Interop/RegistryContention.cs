@@ -0,0 +1,36 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System.Runtime.InteropServices;
+
+namespace BadEcho.Hooks.Interop;
+
+/// <summary>
+/// Represents the contention for the mutex guarding the shared hook registry, accumulated across all processes.
+/// </summary>
+/// <remarks>
+/// Only waits on the mutex while it was held by another thread are counted. Times are performance counter ticks, which
+/// are directly comparable to those of <see cref="System.Diagnostics.Stopwatch.GetTimestamp"/>.
+/// </remarks>
+[StructLayout(LayoutKind.Sequential)]
+internal struct RegistryContention
+{
+    /// <summary>
+    /// The number of times the mutex had to be waited on.
+    /// </summary>
+    public long WaitCount;
+    /// <summary>
+    /// The total time spent waiting on the mutex.
+    /// </summary>
+    public long WaitTicks;
+}
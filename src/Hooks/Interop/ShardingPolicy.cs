@@ -0,0 +1,36 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace BadEcho.Hooks.Interop;
+
+/// <summary>
+/// Specifies how hook events are distributed across multiple destination windows.
+/// </summary>
+public enum ShardingPolicy
+{
+    /// <summary>
+    /// Events are distributed by the identifier of the thread that generated them, preserving the order of events from
+    /// any one thread.
+    /// </summary>
+    Thread,
+    /// <summary>
+    /// Events are distributed by the window they are associated with, preserving the order of events for any one window.
+    /// </summary>
+    /// <remarks>Events with no associated window are all sent to the first destination.</remarks>
+    Window,
+    /// <summary>
+    /// Events are distributed evenly across all destinations with no regard to their order, which is suitable only for
+    /// stateless handlers.
+    /// </summary>
+    RoundRobin
+}
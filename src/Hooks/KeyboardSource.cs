@@ -22,7 +22,10 @@ namespace BadEcho.Hooks;
 /// </summary>
 public sealed class KeyboardSource : HookSource
 {
-    private readonly KeyboardProcedure _callback;
+    private const int MODIFIERS_SHIFT = 16;
+
+    private readonly KeyboardProcedure? _callback;
+    private readonly KeyboardInputProcedure? _inputCallback;
 
     /// <summary>
     /// Initializes a new instance of the <see cref="KeyboardSource"/> class.
@@ -50,10 +53,70 @@ public sealed class KeyboardSource : HookSource
         _callback = callback;
     }
 
+    /// <summary>
+    /// Initializes a new instance of the <see cref="KeyboardSource"/> class.
+    /// </summary>
+    /// <param name="callback">The delegate that will be executed when a hook event has occured.</param>
+    /// <param name="threadId">The identifier of the thread whose message queue will be monitored for keyboard input.</param>
+    public KeyboardSource(KeyboardInputProcedure callback, int threadId)
+        : base(HookType.Keyboard, threadId)
+    {
+        Require.NotNull(callback, nameof(callback));
+
+        _inputCallback = callback;
+    }
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="KeyboardSource"/> class.
+    /// </summary>
+    /// <param name="callback">The delegate that will be executed when a hook event has occured.</param>
+    /// <remarks>This will install a global keyboard hook, capturing keyboard input across all processes.</remarks>
+    public KeyboardSource(KeyboardInputProcedure callback)
+        : base(HookType.LowLevelKeyboard)
+    {
+        Require.NotNull(callback, nameof(callback));
+
+        _inputCallback = callback;
+    }
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="KeyboardSource"/> class.
+    /// </summary>
+    /// <param name="callback">The delegate that will be executed when a hook event has occurred.</param>
+    /// <param name="captureMode">An enumeration value specifying the mechanism used to capture keyboard input.</param>
+    /// <remarks>
+    /// This will capture keyboard input across all processes, either with a global keyboard hook or, if <c>captureMode</c> is
+    /// <see cref="InputCaptureMode.RawInput"/>, by reading raw input in bulk without adding any latency to other applications.
+    /// </remarks>
+    public KeyboardSource(KeyboardProcedure callback, InputCaptureMode captureMode)
+        : base(HookType.LowLevelKeyboard, captureMode)
+    {
+        Require.NotNull(callback, nameof(callback));
+
+        _callback = callback;
+    }
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="KeyboardSource"/> class.
+    /// </summary>
+    /// <param name="callback">The delegate that will be executed when a hook event has occurred.</param>
+    /// <param name="captureMode">An enumeration value specifying the mechanism used to capture keyboard input.</param>
+    /// <remarks>
+    /// This will capture keyboard input across all processes, either with a global keyboard hook or, if <c>captureMode</c> is
+    /// <see cref="InputCaptureMode.RawInput"/>, by reading raw input in bulk without adding any latency to other applications.
+    /// </remarks>
+    public KeyboardSource(KeyboardInputProcedure callback, InputCaptureMode captureMode)
+        : base(HookType.LowLevelKeyboard, captureMode)
+    {
+        Require.NotNull(callback, nameof(callback));
+
+        _inputCallback = callback;
+    }
+
     /// <inheritdoc/>
     protected override void OnHookEvent(IntPtr hWnd, uint msg, IntPtr wParam, IntPtr lParam)
-    {
-        VirtualKey key = (VirtualKey) wParam;
+    {   // The hook procedure packs the keyboard's modifier and lock key states above the virtual-key code.
+        VirtualKey key = (VirtualKey) (wParam & 0xFFFF);
         KeyState state = (WindowMessage) msg switch
         {
             WindowMessage.KeyDown or WindowMessage.SystemKeyDown => KeyState.Down,
@@ -61,6 +124,16 @@ public sealed class KeyboardSource : HookSource
             _ => throw new ArgumentException(Strings.NonKeyboardMessageReceived)
         };
 
-        _callback(state, key);
+        if (_inputCallback != null)
+        {
+            int keyboardModifiers = (int) (wParam >> MODIFIERS_SHIFT);
+            var modifiers = (ModifierKeys) (keyboardModifiers & 0xF);
+            var lockKeys = (LockKeys) ((keyboardModifiers >> 4) & 0x7);
+
+            _inputCallback(state, key, modifiers, lockKeys);
+            return;
+        }
+
+        _callback?.Invoke(state, key);
     }
 }
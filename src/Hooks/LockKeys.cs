@@ -0,0 +1,38 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace BadEcho.Hooks;
+
+/// <summary>
+/// Specifies lock keys that are toggled on.
+/// </summary>
+[Flags]
+public enum LockKeys
+{
+    /// <summary>
+    /// No lock keys are toggled on.
+    /// </summary>
+    None = 0x0,
+    /// <summary>
+    /// CAPS LOCK is on.
+    /// </summary>
+    CapsLock = 0x1,
+    /// <summary>
+    /// NUM LOCK is on.
+    /// </summary>
+    NumLock = 0x2,
+    /// <summary>
+    /// SCROLL LOCK is on.
+    /// </summary>
+    ScrollLock = 0x4
+}
@@ -0,0 +1,51 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace BadEcho.Hooks;
+
+/// <summary>
+/// Provides details about a thread whose message pump has stopped retrieving messages from its queue.
+/// </summary>
+public sealed class MessagePumpStall
+{
+    /// <summary>
+    /// Initializes a new instance of the <see cref="MessagePumpStall"/> class.
+    /// </summary>
+    /// <param name="threadId">The identifier of the stalled thread.</param>
+    /// <param name="duration">The amount of time the thread's message pump has been stalled for.</param>
+    /// <param name="retrievalCount">The number of messages the thread has removed from its queue since being watched.</param>
+    internal MessagePumpStall(int threadId, TimeSpan duration, int retrievalCount)
+    {
+        ThreadId = threadId;
+        Duration = duration;
+        RetrievalCount = retrievalCount;
+    }
+
+    /// <summary>
+    /// Gets the identifier of the stalled thread.
+    /// </summary>
+    public int ThreadId
+    { get; }
+
+    /// <summary>
+    /// Gets the amount of time the thread's message pump has been stalled for.
+    /// </summary>
+    public TimeSpan Duration
+    { get; }
+
+    /// <summary>
+    /// Gets the number of messages the thread has removed from its queue since being watched.
+    /// </summary>
+    public int RetrievalCount
+    { get; }
+}
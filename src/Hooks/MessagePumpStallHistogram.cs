@@ -0,0 +1,87 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+namespace BadEcho.Hooks;
+
+/// <summary>
+/// Provides a distribution of the lengths of stalls observed in watched message pumps.
+/// </summary>
+/// <remarks>
+/// Stall lengths are grouped into buckets whose upper bounds double with each bucket, starting at one millisecond.
+/// The final bucket has no upper bound.
+/// </remarks>
+public sealed class MessagePumpStallHistogram
+{
+    private const int BUCKET_COUNT = 17;
+
+    private readonly long[] _counts = new long[BUCKET_COUNT];
+
+    /// <summary>
+    /// Gets the number of buckets stall lengths are grouped into.
+    /// </summary>
+    public int BucketCount
+        => BUCKET_COUNT;
+
+    /// <summary>
+    /// Gets the total number of stall lengths recorded.
+    /// </summary>
+    public long TotalCount
+    {
+        get
+        {
+            long totalCount = 0;
+
+            for (int i = 0; i < BUCKET_COUNT; i++)
+            {
+                totalCount += Interlocked.Read(ref _counts[i]);
+            }
+
+            return totalCount;
+        }
+    }
+
+    /// <summary>
+    /// Gets the number of stall lengths recorded in the specified bucket.
+    /// </summary>
+    /// <param name="bucket">The index of the bucket.</param>
+    /// <returns>The number of stall lengths recorded in <c>bucket</c>.</returns>
+    public long this[int bucket]
+        => Interlocked.Read(ref _counts[bucket]);
+
+    /// <summary>
+    /// Gets the exclusive upper bound for stall lengths recorded in the specified bucket.
+    /// </summary>
+    /// <param name="bucket">The index of the bucket.</param>
+    /// <returns>The exclusive upper bound for <c>bucket</c>, or <see cref="TimeSpan.MaxValue"/> if it is the final bucket.</returns>
+    public static TimeSpan GetUpperBound(int bucket)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegative(bucket);
+        ArgumentOutOfRangeException.ThrowIfGreaterThanOrEqual(bucket, BUCKET_COUNT);
+
+        return bucket == BUCKET_COUNT - 1
+            ? TimeSpan.MaxValue
+            : TimeSpan.FromMilliseconds(1L << bucket);
+    }
+
+    /// <summary>
+    /// Records the length of a stall a message pump has recovered from.
+    /// </summary>
+    /// <param name="duration">The amount of time the message pump went without retrieving messages.</param>
+    internal void Record(TimeSpan duration)
+    {
+        long milliseconds = (long) duration.TotalMilliseconds;
+        int bucket = milliseconds <= 0 ? 0 : Math.Min(BUCKET_COUNT - 1, 64 - (int) ulong.LeadingZeroCount((ulong) milliseconds));
+
+        Interlocked.Increment(ref _counts[bucket]);
+    }
+}
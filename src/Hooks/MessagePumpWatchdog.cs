@@ -0,0 +1,271 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System.Diagnostics;
+using BadEcho.Extensions;
+using BadEcho.Hooks.Interop;
+using BadEcho.Hooks.Properties;
+using BadEcho.Logging;
+
+namespace BadEcho.Hooks;
+
+/// <summary>
+/// Provides a detector of threads whose message pumps have stopped retrieving messages from their queues.
+/// </summary>
+/// <remarks>
+/// <para>
+/// Watched threads have a <c>WH_GETMESSAGE</c> hook procedure installed that does nothing more than record a heartbeat in
+/// shared memory every time a message is retrieved, so no messages are ever sent back to us from the watched threads.
+/// </para>
+/// <para>
+/// An idle thread waiting on an empty queue produces no heartbeats, which by itself would be indistinguishable from a stall.
+/// Threads that have been quiet for a quarter of the stall threshold are therefore sent a <c>WM_NULL</c> probe, which is
+/// posted and thus never blocks us. A thread waiting on its queue retrieves the probe immediately, so a probe left unretrieved
+/// means the thread hasn't returned to its message pump since it last retrieved a message. Stalls are measured from that last
+/// retrieval, and a thread is considered stalled once a probe is outstanding and its stall has lasted longer than the threshold.
+/// Stalls are therefore detected no later than a quarter of the threshold after they cross it.
+/// </para>
+/// <para>
+/// Only a limited number of threads (twenty) can be hooked at any one time, shared among all hooks installed by every process
+/// making use of the hooking library.
+/// </para>
+/// </remarks>
+public sealed class MessagePumpWatchdog : IDisposable
+{
+    private static int _NextOwner;
+
+    private readonly Dictionary<int, long> _stallStarts = [];
+    private readonly Lock _watchedThreadsLock = new();
+    private readonly long _stallThreshold;
+    private readonly long _probeThreshold;
+    private readonly Timer _timer;
+    private readonly int _owner = Interlocked.Increment(ref _NextOwner);
+
+    private bool _disposed;
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="MessagePumpWatchdog"/> class.
+    /// </summary>
+    /// <param name="stallThreshold">
+    /// The amount of time a message pump must go without retrieving messages, while a probe is outstanding, before its thread
+    /// is considered stalled.
+    /// </param>
+    public MessagePumpWatchdog(TimeSpan stallThreshold)
+    {
+        ArgumentOutOfRangeException.ThrowIfLessThanOrEqual(stallThreshold, TimeSpan.Zero);
+
+        StallThreshold = stallThreshold;
+        _stallThreshold = (long) (stallThreshold.TotalSeconds * Stopwatch.Frequency);
+        _probeThreshold = _stallThreshold / 4;
+
+        TimeSpan checkInterval = stallThreshold / 4;
+
+        _timer = new Timer(HandleTimerTick, null, checkInterval, checkInterval);
+    }
+
+    /// <summary>
+    /// Occurs when a watched thread's message pump has been found to be stalled.
+    /// </summary>
+    /// <remarks>This is raised on a thread pool thread for every check made while the thread remains stalled.</remarks>
+    public event EventHandler<EventArgs<MessagePumpStall>>? StallDetected;
+
+    /// <summary>
+    /// Gets the amount of time a message pump must go without retrieving messages, while a probe is outstanding, before its
+    /// thread is considered stalled.
+    /// </summary>
+    public TimeSpan StallThreshold
+    { get; }
+
+    /// <summary>
+    /// Gets the distribution of the lengths of stalls that watched message pumps have recovered from.
+    /// </summary>
+    /// <remarks>
+    /// Every stall observed by a check is recorded once the pump resumes, including those that ended before reaching the stall
+    /// threshold.
+    /// </remarks>
+    public MessagePumpStallHistogram Histogram
+    { get; } = new();
+
+    /// <summary>
+    /// Starts watching the message pump of the specified thread.
+    /// </summary>
+    /// <param name="threadId">The identifier of the thread to watch.</param>
+    /// <returns>True if the thread is now being watched; otherwise, false.</returns>
+    public bool Watch(int threadId)
+        => Watch([threadId]);
+
+    /// <summary>
+    /// Starts watching the message pumps of the specified threads.
+    /// </summary>
+    /// <param name="threadIds">The identifiers of the threads to watch.</param>
+    /// <returns>
+    /// True if all the threads are now being watched; otherwise, false, with none of the threads not already being watched
+    /// having been added.
+    /// </returns>
+    /// <remarks>
+    /// <para>
+    /// All threads are hooked in a single transaction, which is far cheaper than watching a large number of threads one at a
+    /// time.
+    /// </para>
+    /// <para>
+    /// No more than twenty threads can be hooked at once across all processes using the hooking library; a request that would
+    /// exceed that limit fails as a whole.
+    /// </para>
+    /// </remarks>
+    public bool Watch(IEnumerable<int> threadIds)
+    {
+        ArgumentNullException.ThrowIfNull(threadIds);
+        ObjectDisposedException.ThrowIf(_disposed, this);
+
+        lock (_watchedThreadsLock)
+        {
+            HookChange[] changes
+                = threadIds.Distinct()
+                           .Where(threadId => !_stallStarts.ContainsKey(threadId))
+                           .Select(threadId => HookChange.Install(HookType.GetMessage, IntPtr.Zero, threadId, HookOptions.HeartbeatOnly))
+                           .ToArray();
+
+            if (changes.Length == 0)
+                return true;
+
+            if (!Native.ApplyHookChanges(changes, changes.Length, _owner))
+                return false;
+
+            foreach (HookChange change in changes)
+            {
+                _stallStarts.Add(change.ThreadId, 0);
+            }
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Stops watching the message pump of the specified thread.
+    /// </summary>
+    /// <param name="threadId">The identifier of the thread to stop watching.</param>
+    public void Unwatch(int threadId)
+        => Unwatch([threadId]);
+
+    /// <summary>
+    /// Stops watching the message pumps of the specified threads.
+    /// </summary>
+    /// <param name="threadIds">The identifiers of the threads to stop watching.</param>
+    public void Unwatch(IEnumerable<int> threadIds)
+    {
+        ArgumentNullException.ThrowIfNull(threadIds);
+
+        lock (_watchedThreadsLock)
+        {
+            HookChange[] changes
+                = threadIds.Distinct()
+                           .Where(_stallStarts.Remove)
+                           .Select(threadId => HookChange.Uninstall(HookType.GetMessage, threadId))
+                           .ToArray();
+
+            if (changes.Length == 0 || Native.ApplyHookChanges(changes, changes.Length, _owner))
+                return;
+
+            foreach (HookChange change in changes.Where(c => !c.Succeeded))
+            {
+                Logger.Warning(Strings.UnhookFailed.InvariantFormat(change.ThreadId));
+            }
+        }
+    }
+
+    /// <summary>
+    /// Checks the message pumps of all watched threads, probing those that have gone quiet.
+    /// </summary>
+    /// <returns>A collection of details for all watched threads whose message pumps are currently stalled.</returns>
+    public IReadOnlyCollection<MessagePumpStall> Check()
+    {
+        var stalls = new List<MessagePumpStall>();
+        var stallStarts = new List<(int ThreadId, long StallStart)>();
+
+        lock (_watchedThreadsLock)
+        {
+            long now = Stopwatch.GetTimestamp();
+
+            foreach ((int threadId, long stallStart) in _stallStarts)
+            {
+                if (!Native.GetMessagePumpData(threadId, out PumpData pumpData))
+                    continue;
+
+                if (pumpData.LastProbeTime == 0 || pumpData.ProbeResponseTime >= pumpData.LastProbeTime)
+                {   // No probe is outstanding. A stall seen by an earlier check is recorded now that the pump has resumed.
+                    if (stallStart != 0)
+                    {
+                        Histogram.Record(Stopwatch.GetElapsedTime(stallStart, pumpData.ProbeResponseTime));
+                        stallStarts.Add((threadId, 0));
+                    }
+
+                    if (now - pumpData.LastPumpTime >= _probeThreshold)
+                        Native.ProbeMessagePump(threadId);
+
+                    continue;
+                }
+
+                // Probes are only sent by checks, so an outstanding one has gone unretrieved since at least the previous
+                // check, meaning the pump hasn't been waiting on its queue since it last retrieved a message.
+                if (stallStart != pumpData.LastPumpTime)
+                    stallStarts.Add((threadId, pumpData.LastPumpTime));
+
+                long stalledFor = now - pumpData.LastPumpTime;
+
+                if (stalledFor < _stallThreshold)
+                    continue;
+
+                var stall = new MessagePumpStall(threadId,
+                                                 Stopwatch.GetElapsedTime(pumpData.LastPumpTime, now),
+                                                 pumpData.RetrievalCount);
+                stalls.Add(stall);
+            }
+
+            foreach ((int threadId, long stallStart) in stallStarts)
+            {
+                _stallStarts[threadId] = stallStart;
+            }
+        }
+
+        return stalls;
+    }
+
+    /// <inheritdoc/>
+    public void Dispose()
+    {
+        if (_disposed)
+            return;
+
+        _timer.Dispose();
+
+        lock (_watchedThreadsLock)
+        {
+            int removedCount = Native.RemoveOwnedHooks(_owner);
+
+            if (removedCount != _stallStarts.Count)
+                Logger.Warning(Strings.WatchdogUnhookFailed.InvariantFormat(_stallStarts.Count - removedCount));
+
+            _stallStarts.Clear();
+        }
+
+        _disposed = true;
+    }
+
+    private void HandleTimerTick(object? state)
+    {
+        foreach (MessagePumpStall stall in Check())
+        {
+            StallDetected?.Invoke(this, new EventArgs<MessagePumpStall>(stall));
+        }
+    }
+}
@@ -21,6 +21,7 @@ namespace BadEcho.Hooks;
 public sealed class MessageQueueSource : HookSource
 {
     private readonly GetMessageProcedure _callback;
+    private readonly PeekMessageProcedure? _peekCallback;
 
     /// <summary>
     /// Initializes a new instance of the <see cref="MessageQueueSource"/> class.
@@ -35,9 +36,41 @@ public sealed class MessageQueueSource : HookSource
         _callback = callback;
     }
 
+    /// <summary>
+    /// Initializes a new instance of the <see cref="MessageQueueSource"/> class.
+    /// </summary>
+    /// <param name="callback">The delegate that will be executed when a message is being removed from the queue.</param>
+    /// <param name="peekCallback">
+    /// The delegate that will be executed when a message is being examined, but not removed, from the queue.
+    /// </param>
+    /// <param name="threadId">The identifier for the thread whose message queue we're hooking into.</param>
+    /// <remarks>
+    /// Applications that poll their queue with <c>PeekMessage</c> will typically examine the same message many times before
+    /// removing it, so expect <c>peekCallback</c> to be executed a great deal more often than <c>callback</c>.
+    /// </remarks>
+    public MessageQueueSource(GetMessageProcedure callback, PeekMessageProcedure peekCallback, int threadId)
+        : base(HookType.GetMessage, threadId, HookOptions.ObservePeeks)
+    {
+        Require.NotNull(callback, nameof(callback));
+        Require.NotNull(peekCallback, nameof(peekCallback));
+
+        _callback = callback;
+        _peekCallback = peekCallback;
+    }
+
     /// <inheritdoc/>
     protected override void OnHookEvent(IntPtr hWnd, uint msg, IntPtr wParam, IntPtr lParam)
-    {
+        => OnHookEvent(hWnd, msg, wParam, lParam, HookEventAttributes.None);
+
+    /// <inheritdoc/>
+    protected override void OnHookEvent(IntPtr hWnd, uint msg, IntPtr wParam, IntPtr lParam, HookEventAttributes attributes)
+    {   // Peeked messages are only ever forwarded to us if we've asked for them, and can't be changed.
+        if ((attributes & HookEventAttributes.Peeked) == HookEventAttributes.Peeked)
+        {
+            _peekCallback?.Invoke(msg, wParam, lParam);
+            return;
+        }
+
         uint localMsg = msg;
         IntPtr localWParam = wParam;
         IntPtr localLParam = lParam;
@@ -50,6 +50,23 @@ public sealed class MouseSource : HookSource
         _callback = callback;
     }
 
+    /// <summary>
+    /// Initializes a new instance of the <see cref="MouseSource"/> class.
+    /// </summary>
+    /// <param name="callback">The delegate that will be executed when a hook event has occurred.</param>
+    /// <param name="captureMode">An enumeration value specifying the mechanism used to capture mouse input.</param>
+    /// <remarks>
+    /// This will capture mouse input across all processes, either with a global mouse hook or, if <c>captureMode</c> is
+    /// <see cref="InputCaptureMode.RawInput"/>, by reading raw input in bulk without adding any latency to other applications.
+    /// </remarks>
+    public MouseSource(MouseProcedure callback, InputCaptureMode captureMode)
+        : base(HookType.LowLevelMouse, captureMode)
+    {
+        Require.NotNull(callback, nameof(callback));
+
+        _callback = callback;
+    }
+
     /// <inheritdoc/>
     protected override void OnHookEvent(IntPtr hWnd, uint msg, IntPtr wParam, IntPtr lParam)
     {
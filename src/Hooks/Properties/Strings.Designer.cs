@@ -87,6 +87,15 @@ namespace BadEcho.Hooks.Properties {
             }
         }
         
+        /// <summary>
+        ///   Looks up a localized string similar to Raw input can only be used to capture the input of low-level keyboard and mouse hook types..
+        /// </summary>
+        internal static string RawInputRequiresLowLevelHookType {
+            get {
+                return ResourceManager.GetString("RawInputRequiresLowLevelHookType", resourceCulture);
+            }
+        }
+        
         /// <summary>
         ///   Looks up a localized string similar to Failed to unregister hook for thread with ID &apos;{0}&apos;..
         /// </summary>
@@ -95,5 +104,14 @@ namespace BadEcho.Hooks.Properties {
                 return ResourceManager.GetString("UnhookFailed", resourceCulture);
             }
         }
+        
+        /// <summary>
+        ///   Looks up a localized string similar to Failed to unregister {0} hooks installed by the message pump watchdog..
+        /// </summary>
+        internal static string WatchdogUnhookFailed {
+            get {
+                return ResourceManager.GetString("WatchdogUnhookFailed", resourceCulture);
+            }
+        }
     }
 }
@@ -73,6 +73,38 @@ public sealed class WindowSource : HookSource
         _callback = callback;
     }
 
+    /// <summary>
+    /// Initializes a new instance of the <see cref="WindowSource"/> class.
+    /// </summary>
+    /// <param name="callback">The delegate that will be executed when a hook event has occured.</param>
+    /// <param name="beforeWindow">
+    /// Value indicating if messages should be intercepted before they're sent to the destination window procedure.
+    /// </param>
+    /// <param name="shardCount">The number of threads that hook events will be distributed across.</param>
+    /// <param name="shardingPolicy">
+    /// An enumeration value specifying how hook events are distributed across the threads.
+    /// </param>
+    /// <remarks>
+    /// <para>
+    /// This will install a global window hook, capturing messages being sent to all windows on the desktop.
+    /// </para>
+    /// <para>
+    /// Distributing the often considerable volume of messages captured by a global window hook across several threads allows
+    /// them to be processed on multiple cores, at the cost of <c>callback</c> being executed concurrently. Use
+    /// <see cref="ShardingPolicy.Window"/> if messages for any one window need to be processed in the order they were sent.
+    /// </para>
+    /// </remarks>
+    public WindowSource(WindowProcedure callback, bool beforeWindow, int shardCount, ShardingPolicy shardingPolicy)
+        : base(beforeWindow ? HookType.CallWindowProcedure : HookType.CallWindowProcedureReturn,
+               HookOptions.None,
+               shardCount,
+               shardingPolicy)
+    {
+        Require.NotNull(callback, nameof(callback));
+
+        _callback = callback;
+    }
+
     /// <inheritdoc/>
     protected override void OnHookEvent(IntPtr hWnd, uint msg, IntPtr wParam, IntPtr lParam) 
         => _callback(hWnd, msg, wParam, lParam);
@@ -0,0 +1,897 @@
+// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+// Measures how the hook registry and hook message delivery scale with the number of processes and threads using them.
+//
+// Usage: BadEcho.Hooks.Benchmarks.exe [--producers 1,2,4] [--threads 1,4,8] [--events 20000] [--output results.json]
+//
+// For every combination of producer process count (N) and hooked thread count (M), the benchmark spawns a host process
+// running M threads with a window each, and N producer processes that send messages to those windows as fast as they can.
+// Producers time every message they send, first with no hook procedures installed and then with a WH_CALLWNDPROC hook
+// procedure installed into every host thread, forwarding each message to a listener window in this process. The
+// difference between the two is the cost each event adds to the hooked thread. The rate at which the listener receives
+// forwarded messages is the end-to-end throughput.
+//
+// Separately, for every producer count, N producers repeatedly install and uninstall a hook procedure into their own
+// threads, timing each operation. Contention for the shared hook registry is measured directly, from the number of times
+// its mutex had to be waited on and the time spent waiting, rather than inferred from the operations' latency.
+//
+// Finally, events are published one at a time to a HookEventChannel read by a ConsumerTask, first with a consumer that
+// does no work and then with one that spends time on every batch it reads. Publishing is timed to show that a slow
+// consumer never holds up the publishing thread, and the number of batches read shows how events pile up between reads.
+//
+// Results are written as JSON, to standard output unless a file is specified. A benchmark that fails to run is written as
+// a result with an error, so the output is always a complete JSON document.
+//
+// The channel benchmark only depends on the portable core, and so is also built on other platforms, where it is the only
+// benchmark run. The producer and thread counts are ignored there.
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+
+#include <windows.h>
+#include <cwchar>
+
+#include "Hooks.h"
+#endif
+
+#include "HookConsumer.h"
+#include "LatencyHistogram.h"
+
+using namespace BadEcho::Hooks;
+
+namespace {
+#ifdef _WIN32
+    /**
+     * Specifies a workload run by a producer process.
+     */
+    enum Scenario
+    {
+        /**
+         * Messages are sent to the host threads' windows, with or without hook procedures installed into them.
+         */
+        DeliveryScenario,
+        /**
+         * Hook procedures are repeatedly installed into and uninstalled from the producer's own thread.
+         */
+        RegistryScenario
+    };
+
+    /**
+     * Represents the measurements taken by a single producer process.
+     */
+    struct ProducerResult
+    {
+        /**
+         * The number of operations the producer performed.
+         */
+        LONGLONG OperationCount;
+        /**
+         * The time taken by each operation, in nanoseconds.
+         */
+        LatencyHistogram Latency;
+    };
+
+    /**
+     * The maximum number of producer processes that can take part in a run.
+     */
+    constexpr int MaxProducers = 16;
+    /**
+     * The maximum number of host threads that can be hooked in a run, which is the capacity of the hook registry.
+     */
+    constexpr int MaxHookedThreads = 20;
+    /**
+     * The owner token used for the hook procedures installed into the host threads.
+     */
+    constexpr int BenchmarkOwner = 0x42454E43;
+    /**
+     * The number of milliseconds to wait for a producer process to be ready to start its workload.
+     */
+    constexpr DWORD ProducerStartTimeout = 10000;
+
+    constexpr wchar_t HostWindowClass[] = L"BadEcho.Hooks.Benchmarks.Host";
+    constexpr wchar_t ListenerWindowClass[] = L"BadEcho.Hooks.Benchmarks.Listener";
+
+    LONGLONG ListenerEventCount;
+#endif
+
+    /**
+     * The message producers send to the host threads' windows, and that events published to the channel carry.
+     */
+    constexpr unsigned int BenchmarkMessage = 0x8001; // WM_APP + 1
+    /**
+     * The number of microseconds the slow consumer in the channel benchmark spends on every batch it reads.
+     */
+    constexpr int SlowConsumerMicroseconds = 50;
+    /**
+     * The maximum number of events the consumer in the channel benchmark reads at once, the same as a hook subscription.
+     */
+    constexpr std::size_t ConsumerBatchSize = 256;
+    /**
+     * The number of clock ticks in a second.
+     */
+    constexpr std::int64_t Frequency = std::chrono::steady_clock::period::den / std::chrono::steady_clock::period::num;
+
+    std::int64_t Now()
+    {   // On Windows, the steady clock is read from the performance counter, so this is just as precise as querying it.
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    std::uint64_t ToNanoseconds(std::int64_t ticks)
+    {
+        return static_cast<std::uint64_t>(static_cast<double>(ticks) * 1'000'000'000 / static_cast<double>(Frequency));
+    }
+
+    double ToRate(std::int64_t count, std::int64_t elapsedTicks)
+    {
+        return elapsedTicks == 0 ? 0 : static_cast<double>(count) * static_cast<double>(Frequency) / static_cast<double>(elapsedTicks);
+    }
+
+    void WriteLatency(FILE* output, const char* name, const LatencyHistogram& latency)
+    {
+        std::fprintf(output,
+                     "      \"%s\": { \"mean\": %.0f, \"p50\": %" PRIu64 ", \"p90\": %" PRIu64 ", \"p99\": %" PRIu64
+                     ", \"p999\": %" PRIu64 ", \"max\": %" PRIu64 " }",
+                     name,
+                     latency.Mean(),
+                     latency.Percentile(50),
+                     latency.Percentile(90),
+                     latency.Percentile(99),
+                     latency.Percentile(99.9),
+                     latency.Max());
+    }
+
+    void WriteSuiteHeader(FILE* output, int eventCount)
+    {
+        std::fprintf(output, "{\n");
+        std::fprintf(output, "  \"suite\": \"BadEcho.Hooks\",\n");
+        std::fprintf(output, "  \"architecture\": \"%s\",\n", sizeof(void*) == 8 ? "x64" : "x86");
+        std::fprintf(output, "  \"processorCount\": %u,\n", std::thread::hardware_concurrency());
+        std::fprintf(output, "  \"eventsPerProducer\": %d,\n", eventCount);
+    }
+
+    ConsumerTask ConsumeChannel(HookEventChannel& channel, std::int64_t batchTicks, std::int64_t& readCount, std::int64_t& batchCount)
+    {
+        while (true)
+        {
+            std::vector<HookEvent> batch = co_await channel.ReadBatchAsync(ConsumerBatchSize);
+
+            if (batch.empty())
+                co_return;
+
+            readCount += static_cast<std::int64_t>(batch.size());
+            batchCount++;
+
+            // Spinning keeps the consumer's thread busy for the whole time, the same as real work would.
+            for (std::int64_t start = Now(); Now() - start < batchTicks;)
+            { }
+        }
+    }
+
+    void RunChannelBenchmark(FILE* output, int consumerMicroseconds, int eventCount)
+    {
+        HookEventChannel channel(static_cast<size_t>(eventCount));
+        LatencyHistogram latency;
+        std::int64_t readCount = 0;
+        std::int64_t batchCount = 0;
+        std::int64_t started = Now();
+
+        {
+            ConsumerTask consumer = ConsumeChannel(channel, Frequency * consumerMicroseconds / 1'000'000, readCount, batchCount);
+
+            for (int i = 0; i < eventCount; i++)
+            {
+                std::int64_t start = Now();
+                channel.Publish(HookEvent { CallWindowProcedure, BenchmarkMessage, static_cast<std::uintptr_t>(i), 0, NoEventAttributes });
+                latency.Record(ToNanoseconds(Now() - start));
+            }
+
+            channel.Close();
+            consumer.Wait();
+        }
+
+        std::int64_t elapsedTicks = Now() - started;
+
+        std::fprintf(output, "    {\n");
+        std::fprintf(output, "      \"scenario\": \"channel\",\n");
+        std::fprintf(output, "      \"consumerBatchMicroseconds\": %d,\n", consumerMicroseconds);
+        std::fprintf(output, "      \"events\": %d,\n", eventCount);
+        std::fprintf(output, "      \"receivedEvents\": %" PRId64 ",\n", readCount);
+        std::fprintf(output, "      \"droppedEvents\": %" PRIu64 ",\n", channel.DroppedCount());
+        std::fprintf(output, "      \"batches\": %" PRId64 ",\n", batchCount);
+        std::fprintf(output, "      \"meanBatchSize\": %.1f,\n", batchCount == 0 ? 0 : static_cast<double>(readCount) / static_cast<double>(batchCount));
+        std::fprintf(output, "      \"elapsedSeconds\": %.6f,\n", static_cast<double>(elapsedTicks) / static_cast<double>(Frequency));
+        std::fprintf(output, "      \"throughputPerSecond\": %.0f,\n", ToRate(readCount, elapsedTicks));
+        WriteLatency(output, "publishLatencyNanoseconds", latency);
+        std::fprintf(output, "\n    }");
+    }
+
+    void RunChannelBenchmarks(FILE* output, int eventCount)
+    {
+        RunChannelBenchmark(output, 0, eventCount);
+        std::fprintf(output, ",\n");
+        RunChannelBenchmark(output, SlowConsumerMicroseconds, eventCount);
+    }
+
+#ifdef _WIN32
+    std::wstring GetSessionObjectName(DWORD session, const wchar_t* suffix)
+    {
+        return L"BadEcho.Hooks.Benchmarks." + std::to_wstring(session) + L"." + suffix;
+    }
+
+    std::vector<int> ParseList(const wchar_t* text)
+    {
+        std::vector<int> values;
+        wchar_t* end = nullptr;
+
+        for (const wchar_t* next = text; *next != L'\0'; next = *end == L',' ? end + 1 : end)
+        {
+            values.push_back(static_cast<int>(std::wcstol(next, &end, 10)));
+
+            if (end == next)
+                break;
+        }
+
+        return values;
+    }
+
+    LRESULT CALLBACK HostWndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+    {
+        switch (message)
+        {
+            case BenchmarkMessage:
+                return 0;
+
+            case WM_DESTROY:
+                PostQuitMessage(0);
+                return 0;
+
+            default:
+                return DefWindowProc(hWnd, message, wParam, lParam);
+        }
+    }
+
+    LRESULT CALLBACK ListenerWndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+    {   // The host windows receive plenty of other messages, which the hook forwards along with ours, that we aren't counting.
+        if (message == GetHookEventMessage())
+        {
+            HookEventPayload payload;
+
+            // Payloads are read even though we don't need them, as every real listener pays for doing so.
+            if (ReadHookEventPayload(wParam, lParam, &payload)
+                && (wParam >> HookEventMessageShift & 0xFFFF) == BenchmarkMessage)
+            {
+                ListenerEventCount++;
+            }
+
+            return 0;
+        }
+
+        return DefWindowProc(hWnd, message, wParam, lParam);
+    }
+
+    HWND CreateBenchmarkWindow(const wchar_t* className, WNDPROC windowProcedure, HWND parent)
+    {
+        WNDCLASSEXW windowClass {};
+        windowClass.cbSize = sizeof(WNDCLASSEXW);
+        windowClass.lpfnWndProc = windowProcedure;
+        windowClass.hInstance = GetModuleHandle(nullptr);
+        windowClass.lpszClassName = className;
+
+        // Registration fails harmlessly for every thread after the first.
+        RegisterClassExW(&windowClass);
+
+        return CreateWindowExW(0, className, L"", 0, 0, 0, 0, 0, parent, nullptr, GetModuleHandle(nullptr), nullptr);
+    }
+
+    void PumpMessages()
+    {
+        MSG msg;
+
+        while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+        {
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
+        }
+    }
+
+    void WaitWhilePumping(const std::vector<HANDLE>& handles)
+    {   // The hook procedures send their messages to our listener window synchronously, so we must keep pumping messages
+        // the entire time the producers are running, lest they deadlock.
+        for (HANDLE handle : handles)
+        {
+            while (MsgWaitForMultipleObjects(1, &handle, FALSE, INFINITE, QS_ALLINPUT) == WAIT_OBJECT_0 + 1)
+            {
+                PumpMessages();
+            }
+        }
+    }
+
+    HANDLE StartProcess(const std::wstring& arguments)
+    {
+        wchar_t path[MAX_PATH];
+        GetModuleFileNameW(nullptr, path, MAX_PATH);
+
+        std::wstring commandLine = L"\"" + std::wstring(path) + L"\" " + arguments;
+        STARTUPINFOW startupInfo { sizeof(STARTUPINFOW) };
+        PROCESS_INFORMATION processInfo {};
+
+        if (!CreateProcessW(nullptr, commandLine.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startupInfo, &processInfo))
+            return nullptr;
+
+        CloseHandle(processInfo.hThread);
+
+        return processInfo.hProcess;
+    }
+
+    int RunHost(int threadCount, DWORD session)
+    {
+        HANDLE ready = OpenEventW(EVENT_MODIFY_STATE, FALSE, GetSessionObjectName(session, L"Ready").c_str());
+
+        if (ready == nullptr)
+            return 1;
+
+        std::vector<std::thread> threads;
+        LONG createdCount = 0;
+
+        for (int i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back([&]
+            {
+                CreateBenchmarkWindow(HostWindowClass, HostWndProc, nullptr);
+
+                if (InterlockedIncrement(&createdCount) == threadCount)
+                    SetEvent(ready);
+
+                MSG msg;
+
+                while (GetMessage(&msg, nullptr, 0, 0))
+                {
+                    DispatchMessage(&msg);
+                }
+            });
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        CloseHandle(ready);
+
+        return 0;
+    }
+
+    void RunDelivery(ProducerResult& result, const std::vector<HWND>& targets, int eventCount)
+    {
+        for (int i = 0; i < eventCount; i++)
+        {
+            LONGLONG start = Now();
+            SendMessage(targets[i % targets.size()], BenchmarkMessage, i, 0);
+            result.Latency.Record(ToNanoseconds(Now() - start));
+        }
+
+        result.OperationCount = eventCount;
+    }
+
+    void RunRegistry(ProducerResult& result, int eventCount)
+    {
+        auto threadId = static_cast<int>(GetCurrentThreadId());
+
+        for (int i = 0; i < eventCount; i++)
+        {
+            LONGLONG start = Now();
+
+            if (!AddHook(GetMessages, nullptr, threadId, HeartbeatOnly))
+                continue;
+
+            LONGLONG added = Now();
+            RemoveHook(GetMessages, threadId);
+
+            result.Latency.Record(ToNanoseconds(added - start));
+            result.Latency.Record(ToNanoseconds(Now() - added));
+            result.OperationCount += 2;
+        }
+    }
+
+    int RunProducer(Scenario scenario, DWORD session, int index, int eventCount, const wchar_t* targetList)
+    {
+        HANDLE start = OpenEventW(SYNCHRONIZE, FALSE, GetSessionObjectName(session, L"Start").c_str());
+        HANDLE ready = OpenSemaphoreW(SEMAPHORE_MODIFY_STATE, FALSE, GetSessionObjectName(session, L"ProducersReady").c_str());
+        HANDLE mapping = OpenFileMappingW(FILE_MAP_WRITE, FALSE, GetSessionObjectName(session, L"Results").c_str());
+
+        if (start == nullptr || ready == nullptr || mapping == nullptr || index < 0 || index >= MaxProducers)
+            return 1;
+
+        auto results = static_cast<ProducerResult*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0));
+
+        if (results == nullptr)
+            return 1;
+
+        std::vector<HWND> targets;
+
+        for (int target : ParseList(targetList))
+        {
+            targets.push_back(reinterpret_cast<HWND>(static_cast<INT_PTR>(target)));
+        }
+
+        ProducerResult& result = results[index];
+
+        ReleaseSemaphore(ready, 1, nullptr);
+        WaitForSingleObject(start, INFINITE);
+
+        if (scenario == RegistryScenario)
+            RunRegistry(result, eventCount);
+        else if (!targets.empty())
+            RunDelivery(result, targets, eventCount);
+
+        UnmapViewOfFile(results);
+        CloseHandle(mapping);
+        CloseHandle(ready);
+        CloseHandle(start);
+
+        return 0;
+    }
+
+    /**
+     * Represents a set of producer processes sharing a single session's start event and results.
+     */
+    class ProducerSet
+    {
+    public:
+        ProducerSet()
+            : _start(CreateEventW(nullptr, TRUE, FALSE, GetSessionObjectName(GetCurrentProcessId(), L"Start").c_str())),
+              _ready(CreateSemaphoreW(nullptr,
+                                      0,
+                                      MaxProducers,
+                                      GetSessionObjectName(GetCurrentProcessId(), L"ProducersReady").c_str())),
+              _mapping(CreateFileMappingW(INVALID_HANDLE_VALUE,
+                                          nullptr,
+                                          PAGE_READWRITE,
+                                          0,
+                                          sizeof(ProducerResult) * MaxProducers,
+                                          GetSessionObjectName(GetCurrentProcessId(), L"Results").c_str())),
+              _results(static_cast<ProducerResult*>(MapViewOfFile(_mapping, FILE_MAP_WRITE, 0, 0, 0)))
+        { }
+
+        ProducerSet(const ProducerSet&) = delete;
+        ProducerSet& operator=(const ProducerSet&) = delete;
+
+        ~ProducerSet()
+        {
+            UnmapViewOfFile(_results);
+            CloseHandle(_mapping);
+            CloseHandle(_ready);
+            CloseHandle(_start);
+        }
+
+        /**
+         * Runs a workload across a number of producer processes, waiting for all of them to finish.
+         * @param scenario The workload to run.
+         * @param producerCount The number of producer processes to run it in.
+         * @param eventCount The number of operations each producer performs.
+         * @param targets The windows that producers send messages to, if delivering them.
+         * @param elapsedTicks The variable that receives the performance counter ticks elapsed from start to finish.
+         * @return The combined measurements of all producers.
+         */
+        ProducerResult Run(Scenario scenario, int producerCount, int eventCount, const std::vector<HWND>& targets, LONGLONG& elapsedTicks)
+        {
+            std::wstring targetList;
+
+            for (HWND target : targets)
+            {
+                targetList += (targetList.empty() ? L"" : L",") + std::to_wstring(reinterpret_cast<INT_PTR>(target));
+            }
+
+            ResetEvent(_start);
+
+            for (int i = 0; i < MaxProducers; i++)
+            {
+                _results[i] = ProducerResult {};
+            }
+
+            std::vector<HANDLE> processes;
+
+            for (int i = 0; i < producerCount; i++)
+            {
+                std::wstring arguments = L"--produce " + std::to_wstring(scenario)
+                    + L" " + std::to_wstring(GetCurrentProcessId())
+                    + L" " + std::to_wstring(i)
+                    + L" " + std::to_wstring(eventCount)
+                    + L" " + (targetList.empty() ? L"0" : targetList);
+
+                if (HANDLE process = StartProcess(arguments); process != nullptr)
+                    processes.push_back(process);
+            }
+
+            // Producers are only let loose once all of them are up and running, so their workloads overlap as much as possible.
+            for (size_t i = 0; i < processes.size(); i++)
+            {
+                if (WaitForSingleObject(_ready, ProducerStartTimeout) != WAIT_OBJECT_0)
+                    break;
+            }
+
+            LONGLONG started = Now();
+
+            SetEvent(_start);
+            WaitWhilePumping(processes);
+
+            elapsedTicks = Now() - started;
+
+            ProducerResult combined {};
+
+            for (int i = 0; i < producerCount; i++)
+            {
+                combined.OperationCount += _results[i].OperationCount;
+                combined.Latency.Merge(_results[i].Latency);
+            }
+
+            for (HANDLE process : processes)
+            {
+                CloseHandle(process);
+            }
+
+            return combined;
+        }
+
+    private:
+        HANDLE _start;
+        HANDLE _ready;
+        HANDLE _mapping;
+        ProducerResult* _results;
+    };
+
+    /**
+     * Represents a host process running a number of threads for producers to send messages to.
+     */
+    class Host
+    {
+    public:
+        explicit Host(int threadCount)
+        {
+            HANDLE ready = CreateEventW(nullptr, TRUE, FALSE, GetSessionObjectName(GetCurrentProcessId(), L"Ready").c_str());
+
+            _process = StartProcess(L"--host " + std::to_wstring(threadCount) + L" " + std::to_wstring(GetCurrentProcessId()));
+
+            HANDLE handles[] = { ready, _process };
+
+            if (_process != nullptr && WaitForMultipleObjects(2, handles, FALSE, INFINITE) == WAIT_OBJECT_0)
+                EnumWindows(FindWindows, reinterpret_cast<LPARAM>(this));
+
+            CloseHandle(ready);
+        }
+
+        Host(const Host&) = delete;
+        Host& operator=(const Host&) = delete;
+
+        ~Host()
+        {
+            for (HWND window : _windows)
+            {
+                PostMessage(window, WM_CLOSE, 0, 0);
+            }
+
+            if (_process == nullptr)
+                return;
+
+            if (WaitForSingleObject(_process, 5000) != WAIT_OBJECT_0)
+                TerminateProcess(_process, 1);
+
+            CloseHandle(_process);
+        }
+
+        /**
+         * Gets the windows owned by the host's threads.
+         */
+        const std::vector<HWND>& Windows() const
+        {
+            return _windows;
+        }
+
+        /**
+         * Gets the identifiers of the host's threads.
+         */
+        const std::vector<int>& ThreadIds() const
+        {
+            return _threadIds;
+        }
+
+    private:
+        static BOOL CALLBACK FindWindows(HWND hWnd, LPARAM lParam)
+        {
+            auto host = reinterpret_cast<Host*>(lParam);
+            DWORD processId;
+            DWORD threadId = GetWindowThreadProcessId(hWnd, &processId);
+            wchar_t className[64];
+
+            if (processId == GetProcessId(host->_process)
+                && GetClassNameW(hWnd, className, static_cast<int>(std::size(className))) != 0
+                && wcscmp(className, HostWindowClass) == 0)
+            {
+                host->_windows.push_back(hWnd);
+                host->_threadIds.push_back(static_cast<int>(threadId));
+            }
+
+            return TRUE;
+        }
+
+        HANDLE _process = nullptr;
+        std::vector<HWND> _windows;
+        std::vector<int> _threadIds;
+    };
+
+    std::uint64_t CounterToNanoseconds(LONGLONG counterTicks)
+    {   // The hook registry times its waits with the performance counter, whose frequency needn't match our clock's.
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+
+        return static_cast<std::uint64_t>(static_cast<double>(counterTicks) * 1'000'000'000 / static_cast<double>(frequency.QuadPart));
+    }
+
+    void WriteDeliveryFailure(FILE* output, int producerCount, int threadCount, const char* error)
+    {
+        std::fprintf(output, "    {\n");
+        std::fprintf(output, "      \"scenario\": \"delivery\",\n");
+        std::fprintf(output, "      \"producers\": %d,\n", producerCount);
+        std::fprintf(output, "      \"hookedThreads\": %d,\n", threadCount);
+        std::fprintf(output, "      \"error\": \"%s\"\n", error);
+        std::fprintf(output, "    }");
+    }
+
+    bool RunDeliveryBenchmark(FILE* output, ProducerSet& producers, HWND listener, int producerCount, int threadCount, int eventCount)
+    {
+        Host host(threadCount);
+
+        if (host.Windows().size() != static_cast<size_t>(threadCount))
+        {
+            WriteDeliveryFailure(output, producerCount, threadCount, "The host process failed to create its windows.");
+            return false;
+        }
+
+        LONGLONG baselineTicks;
+        ProducerResult baseline = producers.Run(DeliveryScenario, producerCount, eventCount, host.Windows(), baselineTicks);
+
+        std::vector<HookChange> changes;
+
+        for (int threadId : host.ThreadIds())
+        {
+            changes.push_back(HookChange { CallWindowProcedure, InstallHook, NoOptions, false, threadId, listener });
+        }
+
+        LONGLONG installStart = Now();
+
+        if (!ApplyHookChanges(changes.data(), static_cast<int>(changes.size()), BenchmarkOwner))
+        {
+            WriteDeliveryFailure(output, producerCount, threadCount, "The hook procedures failed to install.");
+            return false;
+        }
+
+        LONGLONG installTicks = Now() - installStart;
+
+        ListenerEventCount = 0;
+
+        LONGLONG hookedTicks;
+        ProducerResult hooked = producers.Run(DeliveryScenario, producerCount, eventCount, host.Windows(), hookedTicks);
+
+        LONGLONG removeStart = Now();
+        RemoveOwnedHooks(BenchmarkOwner);
+        LONGLONG removeTicks = Now() - removeStart;
+
+        std::fprintf(output, "    {\n");
+        std::fprintf(output, "      \"scenario\": \"delivery\",\n");
+        std::fprintf(output, "      \"producers\": %d,\n", producerCount);
+        std::fprintf(output, "      \"hookedThreads\": %d,\n", threadCount);
+        std::fprintf(output, "      \"events\": %lld,\n", hooked.OperationCount);
+        std::fprintf(output, "      \"receivedEvents\": %lld,\n", ListenerEventCount);
+        std::fprintf(output, "      \"elapsedSeconds\": %.6f,\n", static_cast<double>(hookedTicks) / static_cast<double>(Frequency));
+        std::fprintf(output, "      \"throughputPerSecond\": %.0f,\n", ToRate(ListenerEventCount, hookedTicks));
+        std::fprintf(output, "      \"baselineThroughputPerSecond\": %.0f,\n", ToRate(baseline.OperationCount, baselineTicks));
+        std::fprintf(output, "      \"hookCostNanoseconds\": %.0f,\n", hooked.Latency.Mean() - baseline.Latency.Mean());
+        std::fprintf(output, "      \"batchInstallNanoseconds\": %llu,\n", ToNanoseconds(installTicks));
+        std::fprintf(output, "      \"batchRemoveNanoseconds\": %llu,\n", ToNanoseconds(removeTicks));
+        WriteLatency(output, "latencyNanoseconds", hooked.Latency);
+        std::fprintf(output, ",\n");
+        WriteLatency(output, "baselineLatencyNanoseconds", baseline.Latency);
+        std::fprintf(output, "\n    }");
+
+        return true;
+    }
+
+    void RunRegistryBenchmark(FILE* output, ProducerSet& producers, int producerCount, int eventCount)
+    {
+        RegistryContention before {};
+        RegistryContention after {};
+        LONGLONG elapsedTicks;
+
+        GetRegistryContention(&before);
+        ProducerResult result = producers.Run(RegistryScenario, producerCount, eventCount, {}, elapsedTicks);
+        GetRegistryContention(&after);
+
+        LONGLONG waitCount = after.WaitCount - before.WaitCount;
+        LONGLONG waitTicks = after.WaitTicks - before.WaitTicks;
+
+        std::fprintf(output, "    {\n");
+        std::fprintf(output, "      \"scenario\": \"registry\",\n");
+        std::fprintf(output, "      \"producers\": %d,\n", producerCount);
+        std::fprintf(output, "      \"operations\": %lld,\n", result.OperationCount);
+        std::fprintf(output, "      \"elapsedSeconds\": %.6f,\n", static_cast<double>(elapsedTicks) / static_cast<double>(Frequency));
+        std::fprintf(output, "      \"throughputPerSecond\": %.0f,\n", ToRate(result.OperationCount, elapsedTicks));
+        std::fprintf(output, "      \"mutexWaits\": %lld,\n", waitCount);
+        std::fprintf(output, "      \"mutexWaitNanoseconds\": %llu,\n", CounterToNanoseconds(waitTicks));
+        std::fprintf(output, "      \"meanMutexWaitNanoseconds\": %llu,\n", waitCount == 0 ? 0 : CounterToNanoseconds(waitTicks / waitCount));
+        WriteLatency(output, "latencyNanoseconds", result.Latency);
+        std::fprintf(output, "\n    }");
+    }
+
+    std::string ValidateCounts(const std::vector<int>& producerCounts, const std::vector<int>& threadCounts)
+    {
+        for (int producerCount : producerCounts)
+        {
+            if (producerCount < 1 || producerCount > MaxProducers)
+                return "Producer counts must be between 1 and " + std::to_string(MaxProducers) + ".";
+        }
+
+        for (int threadCount : threadCounts)
+        {
+            if (threadCount < 1 || threadCount > MaxHookedThreads)
+                return "Hooked thread counts must be between 1 and " + std::to_string(MaxHookedThreads) + ".";
+        }
+
+        return {};
+    }
+
+    int RunBenchmarks(const std::vector<int>& producerCounts, const std::vector<int>& threadCounts, int eventCount, FILE* output)
+    {
+        WriteSuiteHeader(output, eventCount);
+
+        if (std::string error = ValidateCounts(producerCounts, threadCounts); !error.empty())
+        {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            std::fprintf(output, "  \"error\": \"%s\",\n", error.c_str());
+            std::fprintf(output, "  \"results\": []\n}\n");
+
+            return 1;
+        }
+
+        HWND listener = CreateBenchmarkWindow(ListenerWindowClass, ListenerWndProc, HWND_MESSAGE);
+        ProducerSet producers;
+
+        std::fprintf(output, "  \"results\": [\n");
+
+        bool first = true;
+        bool failed = false;
+
+        for (int producerCount : producerCounts)
+        {
+            for (int threadCount : threadCounts)
+            {
+                if (!first)
+                    std::fprintf(output, ",\n");
+
+                // A failed run still writes its result, with the error, so the remaining benchmarks can go ahead.
+                if (!RunDeliveryBenchmark(output, producers, listener, producerCount, threadCount, eventCount))
+                {
+                    std::fwprintf(stderr, L"Failed to run delivery benchmark with %d producers and %d threads.\n", producerCount, threadCount);
+                    failed = true;
+                }
+
+                first = false;
+            }
+
+            std::fprintf(output, ",\n");
+            RunRegistryBenchmark(output, producers, producerCount, eventCount);
+        }
+
+        DestroyWindow(listener);
+
+        std::fprintf(output, ",\n");
+        RunChannelBenchmarks(output, eventCount);
+        std::fprintf(output, "\n  ]\n}\n");
+
+        return failed ? 1 : 0;
+    }
+#else
+    int RunBenchmarks(int eventCount, FILE* output)
+    {   // Only the channel benchmark can run without Windows, as the others all need hook procedures to be installed.
+        WriteSuiteHeader(output, eventCount);
+
+        std::fprintf(output, "  \"results\": [\n");
+        RunChannelBenchmarks(output, eventCount);
+        std::fprintf(output, "\n  ]\n}\n");
+
+        return 0;
+    }
+#endif
+}
+
+#ifdef _WIN32
+int wmain(int argc, wchar_t* argv[])
+{
+    if (argc == 4 && wcscmp(argv[1], L"--host") == 0)
+        return RunHost(std::wcstol(argv[2], nullptr, 10), std::wcstoul(argv[3], nullptr, 10));
+
+    if (argc == 7 && wcscmp(argv[1], L"--produce") == 0)
+    {
+        return RunProducer(static_cast<Scenario>(std::wcstol(argv[2], nullptr, 10)),
+                           std::wcstoul(argv[3], nullptr, 10),
+                           std::wcstol(argv[4], nullptr, 10),
+                           std::wcstol(argv[5], nullptr, 10),
+                           argv[6]);
+    }
+
+    std::vector<int> producerCounts { 1, 2, 4 };
+    std::vector<int> threadCounts { 1, 4, 8 };
+    int eventCount = 20000;
+    const wchar_t* outputPath = nullptr;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (wcscmp(argv[i], L"--producers") == 0)
+            producerCounts = ParseList(argv[i + 1]);
+        else if (wcscmp(argv[i], L"--threads") == 0)
+            threadCounts = ParseList(argv[i + 1]);
+        else if (wcscmp(argv[i], L"--events") == 0)
+            eventCount = std::wcstol(argv[i + 1], nullptr, 10);
+        else if (wcscmp(argv[i], L"--output") == 0)
+            outputPath = argv[i + 1];
+    }
+
+    FILE* output = stdout;
+
+    if (outputPath != nullptr && _wfopen_s(&output, outputPath, L"w") != 0)
+        return 1;
+
+    int result = RunBenchmarks(producerCounts, threadCounts, eventCount, output);
+
+    if (output != stdout)
+        std::fclose(output);
+
+    return result;
+}
+#else
+int main(int argc, char* argv[])
+{
+    int eventCount = 20000;
+    const char* outputPath = nullptr;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--events") == 0)
+            eventCount = static_cast<int>(std::strtol(argv[i + 1], nullptr, 10));
+        else if (std::strcmp(argv[i], "--output") == 0)
+            outputPath = argv[i + 1];
+    }
+
+    FILE* output = stdout;
+
+    if (outputPath != nullptr && (output = std::fopen(outputPath, "w")) == nullptr)
+        return 1;
+
+    int result = RunBenchmarks(eventCount, output);
+
+    if (output != stdout)
+        std::fclose(output);
+
+    return result;
+}
+#endif
@@ -0,0 +1,158 @@
+// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+/**
+ * Provides a log-linear histogram of the latencies measured by a benchmark, with every power of two split into 16 equal
+ * buckets. A reported percentile is the upper bound of the bucket it lands in, and latencies of 2^49 or more (several
+ * days' worth of nanoseconds) all share the last bucket.
+ * @remarks
+ * The histogram is plain data with no pointers, so it can be recorded to in memory shared between processes and merged
+ * with the histograms of other processes afterward. It is not safe to record to from more than one thread at a time.
+ */
+class LatencyHistogram
+{
+public:
+	/**
+	 * Records a latency.
+	 * @param value The latency to record, in any unit of time, as long as it's consistent.
+	 */
+	void Record(std::uint64_t value)
+	{
+		_counts[GetBucket(value)]++;
+		_count++;
+		_total += value;
+
+		if (value > _max)
+			_max = value;
+	}
+
+	/**
+	 * Adds all the latencies recorded by another histogram to this one.
+	 * @param other The histogram to merge into this one.
+	 */
+	void Merge(const LatencyHistogram& other)
+	{
+		for (int i = 0; i < BucketCount; i++)
+		{
+			_counts[i] += other._counts[i];
+		}
+
+		_count += other._count;
+		_total += other._total;
+
+		if (other._max > _max)
+			_max = other._max;
+	}
+
+	/**
+	 * Gets the number of latencies recorded.
+	 * @return The number of latencies recorded.
+	 */
+	std::uint64_t Count() const
+	{
+		return _count;
+	}
+
+	/**
+	 * Gets the arithmetic mean of the recorded latencies.
+	 * @return The mean latency, or zero if none have been recorded.
+	 */
+	double Mean() const
+	{
+		return _count == 0 ? 0 : static_cast<double>(_total) / static_cast<double>(_count);
+	}
+
+	/**
+	 * Gets the highest recorded latency.
+	 * @return The highest latency, or zero if none have been recorded.
+	 */
+	std::uint64_t Max() const
+	{
+		return _max;
+	}
+
+	/**
+	 * Gets the latency at or below which the specified percentage of recorded latencies fall.
+	 * @param percentile The percentage of recorded latencies, from 0 to 100.
+	 * @return
+	 * The upper bound of the bucket containing the specified percentile, capped at the highest recorded latency, or zero
+	 * if none have been recorded.
+	 */
+	std::uint64_t Percentile(double percentile) const
+	{
+		if (_count == 0)
+			return 0;
+
+		auto targetCount = static_cast<std::uint64_t>(static_cast<double>(_count) * percentile / 100 + 0.5);
+		std::uint64_t cumulativeCount = 0;
+
+		if (targetCount == 0)
+			targetCount = 1;
+
+		for (int i = 0; i < BucketCount; i++)
+		{
+			cumulativeCount += _counts[i];
+
+			if (cumulativeCount >= targetCount)
+			{
+				std::uint64_t upperBound = GetUpperBound(i);
+
+				return upperBound < _max ? upperBound : _max;
+			}
+		}
+
+		return _max;
+	}
+
+private:
+	static constexpr int SubBucketBits = 4;
+	static constexpr int SubBucketCount = 1 << SubBucketBits;
+	static constexpr int MaxExponent = 48;
+	static constexpr int BucketCount = (MaxExponent - SubBucketBits + 2) * SubBucketCount;
+
+	static int GetBucket(std::uint64_t value)
+	{
+		if (value < SubBucketCount)
+			return static_cast<int>(value);
+
+		int exponent = static_cast<int>(std::bit_width(value)) - 1;
+
+		if (exponent > MaxExponent)
+			return BucketCount - 1;
+
+		auto subBucket = static_cast<int>(value >> (exponent - SubBucketBits)) & (SubBucketCount - 1);
+
+		return (exponent - SubBucketBits + 1) * SubBucketCount + subBucket;
+	}
+
+	static std::uint64_t GetUpperBound(int bucket)
+	{
+		if (bucket < SubBucketCount)
+			return static_cast<std::uint64_t>(bucket) + 1;
+
+		int exponent = bucket / SubBucketCount + SubBucketBits - 1;
+		int subBucket = bucket % SubBucketCount;
+
+		return static_cast<std::uint64_t>(SubBucketCount + subBucket + 1) << (exponent - SubBucketBits);
+	}
+
+	std::uint64_t _counts[BucketCount] {};
+	std::uint64_t _count = 0;
+	std::uint64_t _total = 0;
+	std::uint64_t _max = 0;
+};
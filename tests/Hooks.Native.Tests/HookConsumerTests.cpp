@@ -0,0 +1,323 @@
+// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+#include <atomic>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "HookConsumer.h"
+#include "TestFramework.h"
+
+using namespace BadEcho::Hooks;
+
+namespace
+{
+    HookEvent CreateEvent(std::uintptr_t sequence)
+    {
+        return HookEvent{ Keyboard, 0x100, sequence, 0, NoEventAttributes };
+    }
+
+    ConsumerTask Consume(HookEventChannel& channel, std::size_t maxCount, std::stop_token stopToken, std::vector<std::size_t>& batchSizes)
+    {
+        while (true)
+        {
+            std::vector<HookEvent> batch = co_await channel.ReadBatchAsync(maxCount, stopToken);
+
+            if (batch.empty())
+                co_return;
+
+            batchSizes.push_back(batch.size());
+        }
+    }
+}
+
+TEST_CASE(TryReadBatch_PublishedEvents_ReadInOrder)
+{
+    HookEventChannel channel;
+
+    for (std::uintptr_t i = 0; i < 10; i++)
+    {
+        CHECK(channel.Publish(CreateEvent(i)));
+    }
+
+    std::vector<HookEvent> batch;
+
+    CHECK(channel.TryReadBatch(batch, 4) == 4);
+    CHECK(channel.TryReadBatch(batch, 100) == 6);
+    CHECK(channel.TryReadBatch(batch, 100) == 0);
+
+    for (std::uintptr_t i = 0; i < batch.size(); i++)
+    {
+        CHECK(batch[i].WParam == i);
+    }
+}
+
+TEST_CASE(Publish_FullChannel_ExcessDroppedAndCounted)
+{
+    HookEventChannel channel(10);
+    std::vector<HookEvent> events(25, CreateEvent(0));
+
+    CHECK(channel.Publish(events) == 10);
+    CHECK(!channel.Publish(CreateEvent(0)));
+    CHECK(channel.DroppedCount() == 16);
+}
+
+TEST_CASE(Publish_ClosedChannel_NothingAdded)
+{
+    HookEventChannel channel;
+
+    CHECK(channel.Publish(CreateEvent(0)));
+    channel.Close();
+
+    CHECK(channel.IsClosed());
+    CHECK(!channel.Publish(CreateEvent(1)));
+    CHECK(channel.DroppedCount() == 0);
+
+    std::vector<HookEvent> batch;
+
+    CHECK(channel.TryReadBatch(batch, 100) == 1);
+}
+
+TEST_CASE(ReadBatchAsync_EventsAlreadyPublished_ReadWithoutWaiting)
+{
+    HookEventChannel channel;
+    std::vector<std::size_t> batchSizes;
+
+    for (std::uintptr_t i = 0; i < 5; i++)
+    {
+        channel.Publish(CreateEvent(i));
+    }
+
+    channel.Close();
+
+    ConsumerTask task = Consume(channel, 3, {}, batchSizes);
+    task.Wait();
+
+    CHECK((batchSizes == std::vector<std::size_t>{ 3, 2 }));
+}
+
+TEST_CASE(ReadBatchAsync_WaitingReader_ResumedOnConsumerThread)
+{
+    HookEventChannel channel;
+    std::atomic<std::thread::id> readerThread;
+
+    auto read = [&]() -> ConsumerTask
+    {
+        std::vector<HookEvent> batch = co_await channel.ReadBatchAsync(100);
+
+        readerThread = std::this_thread::get_id();
+        CHECK(batch.size() == 1);
+    };
+
+    ConsumerTask task = read();
+
+    // Give the reader a chance to start waiting; the test holds either way.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    channel.Publish(CreateEvent(0));
+    task.Wait();
+
+    CHECK(readerThread.load() != std::this_thread::get_id());
+}
+
+TEST_CASE(Publish_SlowConsumer_PublisherNeverBlockedAndEventsBatched)
+{
+    constexpr std::size_t eventCount = 1000;
+
+    HookEventChannel channel(eventCount);
+    std::atomic<bool> consumerBlocked = false;
+    std::atomic<bool> publishingDone = false;
+    std::vector<std::size_t> batchSizes;
+
+    auto consume = [&]() -> ConsumerTask
+    {
+        while (true)
+        {
+            std::vector<HookEvent> batch = co_await channel.ReadBatchAsync(eventCount);
+
+            if (batch.empty())
+                co_return;
+
+            batchSizes.push_back(batch.size());
+
+            // The consumer stays busy with its first batch until every event has been published. Were the consumer
+            // resumed on the publishing thread, publishing could never finish and this would never return.
+            if (batchSizes.size() == 1)
+            {
+                consumerBlocked = true;
+                publishingDone.wait(false);
+            }
+        }
+    };
+
+    ConsumerTask task = consume();
+
+    channel.Publish(CreateEvent(0));
+
+    while (!consumerBlocked)
+    {
+        std::this_thread::yield();
+    }
+
+    for (std::uintptr_t i = 1; i < eventCount; i++)
+    {
+        CHECK(channel.Publish(CreateEvent(i)));
+    }
+
+    publishingDone = true;
+    publishingDone.notify_all();
+    channel.Close();
+    task.Wait();
+
+    CHECK((batchSizes == std::vector<std::size_t>{ 1, eventCount - 1 }));
+}
+
+TEST_CASE(ReadBatchAsync_StopRequestedWhileWaiting_YieldsEmptyBatch)
+{
+    HookEventChannel channel;
+    std::stop_source stopSource;
+    std::vector<std::size_t> batchSizes;
+
+    ConsumerTask task = Consume(channel, 100, stopSource.get_token(), batchSizes);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    stopSource.request_stop();
+    task.Wait();
+
+    CHECK(batchSizes.empty());
+    CHECK(task.IsCompleted());
+}
+
+TEST_CASE(ReadBatchAsync_StopAlreadyRequested_YieldsEmptyBatch)
+{
+    HookEventChannel channel;
+    std::stop_source stopSource;
+    std::vector<std::size_t> batchSizes;
+
+    channel.Publish(CreateEvent(0));
+    stopSource.request_stop();
+
+    ConsumerTask task = Consume(channel, 100, stopSource.get_token(), batchSizes);
+    task.Wait();
+
+    CHECK(batchSizes.empty());
+}
+
+TEST_CASE(ReadBatchAsync_ChannelClosedWhileWaiting_YieldsEmptyBatch)
+{
+    HookEventChannel channel;
+    std::vector<std::size_t> batchSizes;
+
+    ConsumerTask task = Consume(channel, 100, {}, batchSizes);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    channel.Close();
+    task.Wait();
+
+    CHECK(batchSizes.empty());
+}
+
+TEST_CASE(ReadBatchAsync_ConcurrentPublishers_EveryEventRead)
+{
+    constexpr std::size_t publisherCount = 4;
+    constexpr std::size_t eventsPerPublisher = 25000;
+
+    HookEventChannel channel(publisherCount * eventsPerPublisher);
+    std::vector<std::size_t> batchSizes;
+
+    ConsumerTask task = Consume(channel, 256, {}, batchSizes);
+    std::vector<std::thread> publishers;
+
+    for (std::size_t i = 0; i < publisherCount; i++)
+    {
+        publishers.emplace_back([&channel]
+        {
+            for (std::uintptr_t j = 0; j < eventsPerPublisher; j++)
+            {
+                channel.Publish(CreateEvent(j));
+            }
+        });
+    }
+
+    for (std::thread& publisher : publishers)
+    {
+        publisher.join();
+    }
+
+    channel.Close();
+    task.Wait();
+
+    std::size_t readCount = 0;
+
+    for (std::size_t batchSize : batchSizes)
+    {
+        CHECK(batchSize <= 256);
+        readCount += batchSize;
+    }
+
+    CHECK(readCount == publisherCount * eventsPerPublisher);
+    CHECK(channel.DroppedCount() == 0);
+}
+
+TEST_CASE(ConsumerTask_ExceptionThrown_RethrownByWait)
+{
+    auto fail = []() -> ConsumerTask
+    {
+        throw std::logic_error("Consumer failed.");
+        co_return;
+    };
+
+    ConsumerTask task = fail();
+    bool rethrown = false;
+
+    try
+    {
+        task.Wait();
+    }
+    catch (const std::logic_error&)
+    {
+        rethrown = true;
+    }
+
+    CHECK(rethrown);
+    CHECK(task.IsCompleted());
+}
+
+TEST_CASE(ToKeyboardEvent_PackedParameters_Unpacked)
+{
+    HookEvent hookEvent{ LowLevelKeyboard,
+                         0x100,
+                         0x41 | static_cast<std::uintptr_t>(ShiftModifier | CapsLockToggled) << KeyboardModifiersShift,
+                         0x80,
+                         NoEventAttributes };
+
+    KeyboardEvent keyboardEvent = ToKeyboardEvent(hookEvent);
+
+    CHECK(keyboardEvent.Message == 0x100);
+    CHECK(keyboardEvent.VirtualKey == 0x41);
+    CHECK(keyboardEvent.Flags == 0x80);
+    CHECK(keyboardEvent.Modifiers == (ShiftModifier | CapsLockToggled));
+}
+
+TEST_CASE(ToMouseEvent_NegativeCoordinates_Preserved)
+{
+    HookEvent hookEvent{ LowLevelMouse, 0x200, static_cast<std::uintptr_t>(-1920), -40, NoEventAttributes };
+
+    MouseEvent mouseEvent = ToMouseEvent(hookEvent);
+
+    CHECK(mouseEvent.Message == 0x200);
+    CHECK(mouseEvent.X == -1920);
+    CHECK(mouseEvent.Y == -40);
+}
@@ -0,0 +1,162 @@
+// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+#include "KeyboardState.h"
+#include "TestFramework.h"
+
+namespace
+{
+    constexpr unsigned int ShiftKey = 0x10;
+    constexpr unsigned int ControlKey = 0x11;
+    constexpr unsigned int MenuKey = 0x12;
+    constexpr unsigned int CapitalKey = 0x14;
+    constexpr unsigned int LeftShiftKey = 0xA0;
+    constexpr unsigned int RightShiftKey = 0xA1;
+    constexpr unsigned int LeftWindowsKey = 0x5B;
+    constexpr unsigned int AKey = 0x41;
+    constexpr unsigned int LeftShiftScanCode = 0x2A;
+    constexpr unsigned int RightShiftScanCode = 0x36;
+
+    bool HasModifier(KeyboardModifiers modifiers, KeyboardModifiers modifier)
+    {
+        return (modifiers & modifier) == modifier;
+    }
+}
+
+TEST_CASE(Seed_HeldKeysAndToggles_ReportedAsModifiers)
+{
+    KeyboardState state;
+
+    CHECK(!state.IsSeeded());
+
+    // Left CTRL and right WIN held, with NUM LOCK on.
+    state.Seed((1U << 2) | (1U << 7), NumLockToggled);
+
+    CHECK(state.IsSeeded());
+    CHECK(state.Modifiers() == (ControlModifier | WindowsModifier | NumLockToggled));
+}
+
+TEST_CASE(Update_BothShiftKeysHeld_ShiftKeptUntilBothReleased)
+{
+    KeyboardState state;
+    state.Seed(0, NoModifiers);
+
+    state.Update(LeftShiftKey, false, false, LeftShiftScanCode);
+    state.Update(RightShiftKey, false, false, RightShiftScanCode);
+
+    CHECK(HasModifier(state.Update(LeftShiftKey, true, false, LeftShiftScanCode), ShiftModifier));
+    CHECK(state.Update(RightShiftKey, true, false, RightShiftScanCode) == NoModifiers);
+}
+
+TEST_CASE(Update_SideAgnosticShift_SideTakenFromScanCode)
+{
+    KeyboardState state;
+    state.Seed(0, NoModifiers);
+
+    state.Update(ShiftKey, false, false, LeftShiftScanCode);
+    state.Update(ShiftKey, false, false, RightShiftScanCode);
+
+    CHECK(HasModifier(state.Update(ShiftKey, true, false, RightShiftScanCode), ShiftModifier));
+    CHECK(state.Update(ShiftKey, true, false, LeftShiftScanCode) == NoModifiers);
+}
+
+TEST_CASE(Update_SideAgnosticControlAndAlt_SideTakenFromExtendedFlag)
+{
+    KeyboardState state;
+    state.Seed(0, NoModifiers);
+
+    state.Update(ControlKey, false, false, 0x1D);
+    state.Update(ControlKey, false, true, 0x1D);
+    state.Update(MenuKey, false, true, 0x38);
+
+    CHECK(HasModifier(state.Update(ControlKey, true, false, 0x1D), ControlModifier));
+    CHECK(state.Update(ControlKey, true, true, 0x1D) == AltModifier);
+    CHECK(state.Update(MenuKey, true, true, 0x38) == NoModifiers);
+}
+
+TEST_CASE(Update_ToggleKeyAutoRepeat_ToggledOnlyOnInitialPress)
+{
+    KeyboardState state;
+    state.Seed(0, NoModifiers);
+
+    CHECK(HasModifier(state.Update(CapitalKey, false, false, 0x3A), CapsLockToggled));
+    CHECK(HasModifier(state.Update(CapitalKey, false, false, 0x3A), CapsLockToggled));
+    CHECK(HasModifier(state.Update(CapitalKey, true, false, 0x3A), CapsLockToggled));
+    CHECK(!HasModifier(state.Update(CapitalKey, false, false, 0x3A), CapsLockToggled));
+}
+
+TEST_CASE(Update_UntrackedKey_StatesUnchanged)
+{
+    KeyboardState state;
+    state.Seed(1U << 6, ScrollLockToggled);
+
+    CHECK(state.Update(AKey, false, false, 0x1E) == (WindowsModifier | ScrollLockToggled));
+    CHECK(state.Update(AKey, true, false, 0x1E) == (WindowsModifier | ScrollLockToggled));
+}
+
+TEST_CASE(Resync_KeyReleasedWhileUnseen_StuckModifierCleared)
+{
+    KeyboardState state;
+    state.Seed(0, NoModifiers);
+
+    state.Update(LeftWindowsKey, false, false, 0x5B);
+
+    // The release went to another thread, so the actual keyboard state is all we have to go on.
+    CHECK(state.Resync(0, NoModifiers));
+    CHECK(state.Update(AKey, false, false, 0x1E) == NoModifiers);
+}
+
+TEST_CASE(Resync_ToggleChangedWhileUnseen_ToggleCorrected)
+{
+    KeyboardState state;
+    state.Seed(0, NoModifiers);
+
+    CHECK(state.Resync(0, CapsLockToggled));
+    CHECK(state.Modifiers() == CapsLockToggled);
+
+    // A press of the toggle key after the resync flips the corrected state.
+    CHECK(state.Update(CapitalKey, false, false, 0x3A) == NoModifiers);
+}
+
+TEST_CASE(Resync_StatesAlreadyInSync_ReportsNoChange)
+{
+    KeyboardState state;
+
+    CHECK(!state.Resync(1U << 1, NumLockToggled));
+    CHECK(state.IsSeeded());
+
+    state.Update(LeftShiftKey, false, false, LeftShiftScanCode);
+
+    CHECK(!state.Resync((1U << 0) | (1U << 1), NumLockToggled));
+    CHECK(state.Modifiers() == (ShiftModifier | NumLockToggled));
+}
+
+TEST_CASE(Invalidate_SeededState_NeedsResyncUntilResynced)
+{
+    KeyboardState state;
+
+    CHECK(state.NeedsResync());
+
+    state.Seed(0, NoModifiers);
+    state.Update(LeftShiftKey, false, false, LeftShiftScanCode);
+
+    CHECK(!state.NeedsResync());
+
+    // Invalidating leaves the key states as they were until the resync actually happens.
+    state.Invalidate();
+
+    CHECK(state.NeedsResync());
+    CHECK(HasModifier(state.Modifiers(), ShiftModifier));
+    CHECK(state.Resync(0, NoModifiers));
+    CHECK(!state.NeedsResync());
+}
@@ -0,0 +1,56 @@
+// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+// Runs the unit tests for the hooking library's header-only native code, none of which depends on Windows.
+//
+// Usage: BadEcho.Hooks.Native.Tests.exe [filter]
+//
+// Only tests whose names contain the filter are run, if one is provided. The exit code is the number of tests that failed.
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+#include "TestFramework.h"
+
+using namespace BadEcho::Hooks::Tests;
+
+int main(int argc, char* argv[])
+{
+    const char* filter = argc > 1 ? argv[1] : "";
+    int runCount = 0;
+    int failedCount = 0;
+
+    for (const TestCase& test : RegisteredTests())
+    {
+        if (std::strstr(test.Name, filter) == nullptr)
+            continue;
+
+        runCount++;
+
+        try
+        {
+            test.Run();
+            std::printf("[PASS] %s\n", test.Name);
+        }
+        catch (const std::exception& ex)
+        {
+            failedCount++;
+            std::printf("[FAIL] %s: %s\n", test.Name, ex.what());
+        }
+    }
+
+    std::printf("%d of %d tests passed.\n", runCount - failedCount, runCount);
+
+    return failedCount;
+}
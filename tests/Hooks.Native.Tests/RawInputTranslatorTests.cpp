@@ -0,0 +1,239 @@
+// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "RawInputTranslator.h"
+#include "TestFramework.h"
+
+namespace
+{
+    constexpr std::uint32_t MouseInputType = 0;
+    constexpr std::uint32_t KeyboardInputType = 1;
+    constexpr std::uint32_t HidInputType = 2;
+    constexpr std::size_t Wow64HeaderPadding = 8;
+
+    /**
+     * Builds a buffer of raw input blocks laid out as GetRawInputBuffer lays them out, for replaying recorded input.
+     */
+    class RawInputBuffer
+    {
+    public:
+        explicit RawInputBuffer(std::size_t headerPadding)
+            : _headerPadding(headerPadding)
+        { }
+
+        void AddKeyboard(std::uint16_t virtualKey, std::uint16_t scanCode, std::uint16_t flags, std::uint32_t message)
+        {
+            RawKeyboardInput keyboard { scanCode, flags, 0, virtualKey, message, 0 };
+
+            Add(KeyboardInputType, &keyboard, sizeof(keyboard));
+        }
+
+        void AddMouse(std::uint16_t buttonFlags, std::int32_t lastX, std::int32_t lastY)
+        {
+            RawMouseInput mouse { 0, 0, buttonFlags, 0, 0, lastX, lastY, 0 };
+
+            Add(MouseInputType, &mouse, sizeof(mouse));
+        }
+
+        void Add(std::uint32_t type, const void* data, std::size_t size)
+        {
+            RawInputHeader header { type, static_cast<std::uint32_t>(sizeof(header) + _headerPadding + size), 0x1234, 0 };
+
+            std::size_t offset = _bytes.size();
+            _bytes.resize(offset + header.Size);
+
+            std::memcpy(_bytes.data() + offset, &header, sizeof(header));
+            std::memcpy(_bytes.data() + offset + sizeof(header) + _headerPadding, data, size);
+
+            // Each block starts on a pointer-sized boundary.
+            _bytes.resize((_bytes.size() + sizeof(std::uintptr_t) - 1) & ~(sizeof(std::uintptr_t) - 1));
+            _count++;
+        }
+
+        std::size_t Translate(RawInputTranslator& translator, std::vector<InputEvent>& events, std::size_t size) const
+        {
+            return translator.TranslateBuffer(_bytes.data(),
+                                              size,
+                                              _count,
+                                              _headerPadding,
+                                              100,
+                                              -20,
+                                              events.data(),
+                                              events.size());
+        }
+
+        std::size_t Translate(RawInputTranslator& translator, std::vector<InputEvent>& events) const
+        {
+            return Translate(translator, events, _bytes.size());
+        }
+
+    private:
+        std::vector<unsigned char> _bytes;
+        std::size_t _headerPadding;
+        unsigned int _count = 0;
+    };
+
+    RawInputBuffer RecordTypingAndClicking(std::size_t headerPadding)
+    {
+        RawInputBuffer buffer(headerPadding);
+
+        buffer.AddKeyboard(0x10, 0x2A, 0x0, 0x100);  // Left SHIFT down.
+        buffer.AddKeyboard(0x41, 0x1E, 0x0, 0x100);  // A down.
+        buffer.AddKeyboard(0xFF, 0x2A, 0x2, 0x100);  // Fake SHIFT from an escape sequence.
+        buffer.AddKeyboard(0x10, 0x2A, 0x1, 0x101);  // Left SHIFT up.
+        buffer.AddMouse(0x0001 | 0x0400, 5, -3);     // Move, left button down, wheel.
+        buffer.AddMouse(0x0002, 0, 0);               // Left button up.
+
+        return buffer;
+    }
+
+    unsigned int VirtualKeyOf(const InputEvent& event)
+    {
+        return static_cast<unsigned int>(event.WParam & 0xFFFF);
+    }
+
+    KeyboardModifiers ModifiersOf(const InputEvent& event)
+    {
+        return static_cast<KeyboardModifiers>(event.WParam >> KeyboardModifiersShift);
+    }
+
+    void CheckTypingAndClicking(const std::vector<InputEvent>& events, std::size_t count)
+    {
+        CHECK(count == 7);
+
+        CHECK(events[0].Message == 0x100);
+        CHECK(VirtualKeyOf(events[0]) == 0xA0);
+        CHECK(ModifiersOf(events[0]) == ShiftModifier);
+
+        CHECK(VirtualKeyOf(events[1]) == 0x41);
+        CHECK(ModifiersOf(events[1]) == ShiftModifier);
+
+        CHECK(events[2].Message == 0x101);
+        CHECK((events[2].LParam & 0x80) == 0x80);
+        CHECK(ModifiersOf(events[2]) == NoModifiers);
+
+        CHECK(events[3].Message == 0x200);
+        CHECK(static_cast<std::intptr_t>(events[3].WParam) == 100);
+        CHECK(events[3].LParam == -20);
+        CHECK(events[4].Message == 0x201);
+        CHECK(events[5].Message == 0x20A);
+        CHECK(events[6].Message == 0x202);
+    }
+}
+
+TEST_CASE(TranslateBuffer_RecordedInput_TranslatedAsLowLevelEvents)
+{
+    RawInputBuffer buffer = RecordTypingAndClicking(0);
+    RawInputTranslator translator;
+    translator.Keyboard().Seed(0, NoModifiers);
+
+    std::vector<InputEvent> events(64);
+
+    CheckTypingAndClicking(events, buffer.Translate(translator, events));
+}
+
+TEST_CASE(TranslateBuffer_Wow64Padding_TranslatedSameAsUnpadded)
+{
+    RawInputBuffer buffer = RecordTypingAndClicking(Wow64HeaderPadding);
+    RawInputTranslator translator;
+    translator.Keyboard().Seed(0, NoModifiers);
+
+    std::vector<InputEvent> events(64);
+
+    CheckTypingAndClicking(events, buffer.Translate(translator, events));
+}
+
+TEST_CASE(TranslateBuffer_RightAltWithoutMessage_SystemKeyMessageDerived)
+{
+    for (std::size_t headerPadding : { std::size_t { 0 }, Wow64HeaderPadding })
+    {
+        RawInputBuffer buffer(headerPadding);
+        buffer.AddKeyboard(0x12, 0x38, 0x2, 0);  // Right ALT down, with no legacy message.
+        buffer.AddKeyboard(0x14, 0x3A, 0x0, 0);  // CAPS LOCK down, with no legacy message.
+
+        RawInputTranslator translator;
+        translator.Keyboard().Seed(0, NoModifiers);
+
+        std::vector<InputEvent> events(64);
+
+        CHECK(buffer.Translate(translator, events) == 2);
+        CHECK(events[0].Message == 0x104);
+        CHECK(VirtualKeyOf(events[0]) == 0xA5);
+        CHECK((events[0].LParam & 0x21) == 0x21);
+        CHECK(events[1].Message == 0x104);
+        CHECK(ModifiersOf(events[1]) == (AltModifier | CapsLockToggled));
+    }
+}
+
+TEST_CASE(TranslateBuffer_HidInput_Skipped)
+{
+    RawInputBuffer buffer(Wow64HeaderPadding);
+    std::uint32_t hidData[] = { 4, 1, 0xFFFFFFFF };
+
+    buffer.Add(HidInputType, hidData, sizeof(hidData));
+    buffer.AddKeyboard(0x41, 0x1E, 0x0, 0x100);
+
+    RawInputTranslator translator;
+    translator.Keyboard().Seed(0, NoModifiers);
+
+    std::vector<InputEvent> events(64);
+
+    CHECK(buffer.Translate(translator, events) == 1);
+    CHECK(VirtualKeyOf(events[0]) == 0x41);
+}
+
+TEST_CASE(TranslateBuffer_LimitedCapacity_StopsBeforeBlockThatMightNotFit)
+{
+    RawInputBuffer buffer = RecordTypingAndClicking(0);
+    RawInputTranslator translator;
+    translator.Keyboard().Seed(0, NoModifiers);
+
+    std::vector<InputEvent> events(RawInputTranslator::MaxEventsPerInput + 1);
+
+    // After two keystrokes, there's no longer room for a block that could be mouse input with every transition set.
+    CHECK(buffer.Translate(translator, events) == 2);
+}
+
+TEST_CASE(TranslateBuffer_TruncatedBuffer_StopsAtIncompleteBlock)
+{
+    RawInputBuffer buffer = RecordTypingAndClicking(Wow64HeaderPadding);
+    RawInputTranslator translator;
+    translator.Keyboard().Seed(0, NoModifiers);
+
+    std::vector<InputEvent> events(64);
+
+    CHECK(buffer.Translate(translator, events, sizeof(RawInputHeader) + 4) == 0);
+}
+
+TEST_CASE(TranslateBuffer_SplitAcrossReads_KeyboardStateCarriedOver)
+{
+    RawInputBuffer first(Wow64HeaderPadding);
+    first.AddKeyboard(0x11, 0x1D, 0x2, 0x100);  // Right CTRL down.
+
+    RawInputBuffer second(Wow64HeaderPadding);
+    second.AddKeyboard(0x43, 0x2E, 0x0, 0x100); // C down.
+
+    RawInputTranslator translator;
+    translator.Keyboard().Seed(0, NoModifiers);
+
+    std::vector<InputEvent> events(64);
+
+    CHECK(first.Translate(translator, events) == 1);
+    CHECK(VirtualKeyOf(events[0]) == 0xA3);
+    CHECK(second.Translate(translator, events) == 1);
+    CHECK(ModifiersOf(events[0]) == ControlModifier);
+}
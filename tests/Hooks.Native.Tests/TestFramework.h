@@ -0,0 +1,89 @@
+// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace BadEcho::Hooks::Tests
+{
+	/**
+	 * Represents a single test registered with the test runner.
+	 */
+	struct TestCase
+	{
+		/**
+		 * The name of the test, in the form of \c Subject_Condition_ExpectedResult.
+		 */
+		const char* Name;
+		/**
+		 * The function that runs the test, which throws a \c TestFailure if any of its checks fail.
+		 */
+		void (*Run)();
+	};
+
+	/**
+	 * Provides the exception thrown when a check made by a test fails.
+	 */
+	class TestFailure : public std::runtime_error
+	{
+	public:
+		/**
+		 * Initializes a new instance of the \c TestFailure class.
+		 * @param file The source file containing the failed check.
+		 * @param line The line number of the failed check.
+		 * @param condition The text of the condition that was false.
+		 */
+		TestFailure(const char* file, int line, const char* condition)
+			: std::runtime_error(std::string(file) + "(" + std::to_string(line) + "): " + condition)
+		{ }
+	};
+
+	/**
+	 * Gets all tests registered with the test runner.
+	 * @return All tests registered with the test runner, in the order they were registered.
+	 */
+	inline std::vector<TestCase>& RegisteredTests()
+	{
+		static std::vector<TestCase> tests;
+
+		return tests;
+	}
+
+	/**
+	 * Provides registration of a test with the test runner upon static initialization.
+	 */
+	struct TestRegistration
+	{
+		TestRegistration(const char* name, void (*run)())
+		{
+			RegisteredTests().push_back(TestCase{ name, run });
+		}
+	};
+}
+
+/**
+ * Defines a test and registers it with the test runner.
+ */
+#define TEST_CASE(name) \
+	static void name(); \
+	static const BadEcho::Hooks::Tests::TestRegistration name##Registration(#name, name); \
+	static void name()
+
+/**
+ * Fails the current test if a condition is false.
+ */
+#define CHECK(condition) \
+	do { if (!(condition)) throw BadEcho::Hooks::Tests::TestFailure(__FILE__, __LINE__, #condition); } while (false)
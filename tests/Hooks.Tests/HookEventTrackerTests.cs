@@ -0,0 +1,69 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System.Diagnostics;
+using BadEcho.Hooks.Interop;
+
+namespace BadEcho.Hooks.Tests;
+
+public class HookEventTrackerTests
+{
+    private readonly HookEventTracker _tracker = new();
+
+    [Fact]
+    public void Record_SkippedSequence_MissingEventsCounted()
+    {
+        Record(1, 0);
+        Record(2, 0);
+        Record(5, 0);
+        Record(6, 0);
+
+        Assert.Equal(4, _tracker.EventCount);
+        Assert.Equal(1, _tracker.GapCount);
+        Assert.Equal(2, _tracker.MissingEventCount);
+    }
+
+    [Fact]
+    public void Record_LateArrival_MissingEventRecovered()
+    {
+        Record(1, 0);
+        Record(3, 0);
+        Record(2, 0);
+
+        Assert.Equal(1, _tracker.GapCount);
+        Assert.Equal(0, _tracker.MissingEventCount);
+    }
+
+    [Fact]
+    public void GetLatencyPercentile_KnownLatencies_ReturnsBucketBounds()
+    {
+        for (int i = 1; i <= 99; i++)
+        {
+            Record(i, 10);
+        }
+
+        Record(100, 1000);
+
+        Assert.Equal(TimeSpan.FromMicroseconds(11), _tracker.GetLatencyPercentile(50));
+        Assert.Equal(TimeSpan.FromMicroseconds(11), _tracker.GetLatencyPercentile(99));
+        Assert.Equal(TimeSpan.FromMicroseconds(1024), _tracker.GetLatencyPercentile(100));
+    }
+
+    private void Record(int sequence, long latencyMicroseconds)
+    {
+        long receiveTime = Stopwatch.GetTimestamp();
+        long latency = latencyMicroseconds * Stopwatch.Frequency / 1_000_000;
+
+        _tracker.Record(new EventStamp { Sequence = sequence, CaptureTime = receiveTime - latency }, receiveTime);
+    }
+}
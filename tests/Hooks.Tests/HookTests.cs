@@ -11,6 +11,7 @@
 // </copyright>
 // -----------------------------------------------------------------------
 
+using System.Diagnostics;
 using BadEcho.Hooks.Interop;
 using BadEcho.Interop;
 
@@ -44,7 +45,7 @@ public class HookTests
         {
             int threadId = process.Threads[0].Id;
 
-            Assert.True(Native.AddHook(HOOK_TYPE, pump.Window.Handle, threadId));
+            Assert.True(Native.AddHook(HOOK_TYPE, pump.Window.Handle, threadId, HookOptions.None));
             Assert.True(Native.RemoveHook(HOOK_TYPE, threadId));
         }
         finally
@@ -69,12 +70,12 @@ public class HookTests
             {
                 int threadId = processes[i].Threads[0].Id;
 
-                Assert.True(Native.AddHook(HOOK_TYPE, pump.Window.Handle, threadId));
+                Assert.True(Native.AddHook(HOOK_TYPE, pump.Window.Handle, threadId, HookOptions.None));
             }
 
             int lastThreadId = processes[MAX_THREADS].Threads[0].Id;
 
-            Assert.False(Native.AddHook(HOOK_TYPE, pump.Window.Handle, lastThreadId));
+            Assert.False(Native.AddHook(HOOK_TYPE, pump.Window.Handle, lastThreadId, HookOptions.None));
         }
         finally
         {
@@ -103,12 +104,12 @@ public class HookTests
             {
                 int threadId = processes[i].Threads[0].Id;
 
-                Assert.True(Native.AddHook(HOOK_TYPE, pump.Window.Handle, threadId));
+                Assert.True(Native.AddHook(HOOK_TYPE, pump.Window.Handle, threadId, HookOptions.None));
                 Assert.True(Native.RemoveHook(HOOK_TYPE, threadId));
 
             }
 
-            Assert.True(Native.AddHook(HOOK_TYPE, pump.Window.Handle, lastThreadId));
+            Assert.True(Native.AddHook(HOOK_TYPE, pump.Window.Handle, lastThreadId, HookOptions.None));
         }
         finally
         {
@@ -120,4 +121,143 @@ public class HookTests
             }
         }
     }
+
+    [Fact]
+    public async Task ApplyHookChangesThenRemoveOwnedHooks_MaxThreads_RemovesAll()
+    {
+        const int owner = 1;
+
+        using var pump = new MessageOnlyExecutor();
+
+        await pump.StartAsync();
+        Assert.NotNull(pump.Window);
+
+        var processes = NativeProcesses.Create(MAX_THREADS);
+        IntPtr destination = pump.Window.Handle.DangerousGetHandle();
+
+        try
+        {
+            HookChange[] changes
+                = processes.Select(p => HookChange.Install(HOOK_TYPE, destination, p.Threads[0].Id, HookOptions.None))
+                           .ToArray();
+
+            Assert.True(Native.ApplyHookChanges(changes, changes.Length, owner));
+            Assert.All(changes, c => Assert.True(c.Succeeded));
+            Assert.Equal(MAX_THREADS, Native.RemoveOwnedHooks(owner));
+            Assert.Equal(0, Native.RemoveOwnedHooks(owner));
+        }
+        finally
+        {
+            foreach (var process in processes)
+            {
+                process.Kill();
+            }
+        }
+    }
+
+    [Fact]
+    public async Task ApplyHookChanges_MoreThanMaxThreads_InstallsNothing()
+    {
+        const int owner = 2;
+
+        using var pump = new MessageOnlyExecutor();
+
+        await pump.StartAsync();
+        Assert.NotNull(pump.Window);
+
+        var processes = NativeProcesses.Create(MAX_THREADS + 1);
+        IntPtr destination = pump.Window.Handle.DangerousGetHandle();
+
+        try
+        {
+            HookChange[] changes
+                = processes.Select(p => HookChange.Install(HOOK_TYPE, destination, p.Threads[0].Id, HookOptions.None))
+                           .ToArray();
+
+            Assert.False(Native.ApplyHookChanges(changes, changes.Length, owner));
+            Assert.All(changes, c => Assert.False(c.Succeeded));
+            Assert.Equal(0, Native.RemoveOwnedHooks(owner));
+
+            // The failed batch must not have left any thread taking up space.
+            Assert.True(Native.ApplyHookChanges(changes[..MAX_THREADS], MAX_THREADS, owner));
+            Assert.Equal(MAX_THREADS, Native.RemoveOwnedHooks(owner));
+        }
+        finally
+        {
+            foreach (var process in processes)
+            {
+                process.Kill();
+            }
+        }
+    }
+
+    [Fact]
+    public async Task AddHook_HeartbeatOnly_ActivityRecordedNothingForwarded()
+    {
+        using var pump = new MessageOnlyExecutor();
+
+        await pump.StartAsync();
+        Assert.NotNull(pump.Window);
+
+        uint hookEventMessage = Native.GetHookEventMessage();
+        int hookEventCount = 0;
+
+        pump.Window.AddCallback(WindowProcedure);
+
+        var process = NativeProcesses.Create(1)[0];
+
+        try
+        {
+            (nint processWindow, int threadId) = NativeProcesses.GetWindowInformation(process);
+
+            Assert.True(Native.AddHook(HookType.GetMessage, pump.Window.Handle, threadId, HookOptions.HeartbeatOnly));
+
+            // The native test application peeks at the second of these private messages after retrieving the first.
+            User32.PostMessage(processWindow, WindowMessage.User + 0x10, IntPtr.Zero, IntPtr.Zero);
+
+            PumpData pumpData = default;
+            var timeout = Stopwatch.StartNew();
+
+            while (timeout.Elapsed < TimeSpan.FromSeconds(3)
+                   && (!Native.GetMessagePumpData(threadId, out pumpData) || pumpData.RetrievalCount < 2))
+            {
+                await Task.Delay(10);
+            }
+
+            Assert.True(Native.RemoveHook(HookType.GetMessage, threadId));
+            Assert.True(pumpData.RetrievalCount >= 2);
+            Assert.NotEqual(0, pumpData.PeekCount);
+            Assert.Equal(0, hookEventCount);
+        }
+        finally
+        {
+            process.Kill();
+        }
+
+        ProcedureResult WindowProcedure(nint hWnd, uint msg, nint wParam, nint lParam)
+        {
+            if (msg == hookEventMessage)
+                Interlocked.Increment(ref hookEventCount);
+
+            return new ProcedureResult(nint.Zero, true);
+        }
+    }
+
+    [Fact]
+    public async Task RegisterUnregisterRawInput_LowLevelKeyboard_ReturnsTrue()
+    {
+        using var pump = new MessageOnlyExecutor();
+
+        await pump.StartAsync();
+        Assert.NotNull(pump.Window);
+
+        WindowHandle destination = pump.Window.Handle;
+
+        // Raw input is only delivered to the thread owning the registered window, so we register from that thread.
+        bool? registered = await pump.InvokeAsync(() => Native.RegisterRawInput(HookType.LowLevelKeyboard, destination));
+        bool? unregistered = await pump.InvokeAsync(() => Native.UnregisterRawInput(HookType.LowLevelKeyboard));
+
+        Assert.True(registered);
+        Assert.True(unregistered);
+    }
 }
@@ -17,6 +17,10 @@ namespace BadEcho.Hooks.Tests;
 
 public class MessageTests : IDisposable
 {
+    // Private messages understood by the native test application, which peeks at the second after being sent the first.
+    private const WindowMessage PEEK_REQUEST_MESSAGE = WindowMessage.User + 0x10;
+    private const WindowMessage PEEKED_MESSAGE = WindowMessage.User + 0x11;
+
     private readonly ManualResetEventSlim _mre = new();
 
     public MessageTests()
@@ -61,6 +65,128 @@ public class MessageTests : IDisposable
         }
     }
     
+    [Fact]
+    public async Task MessageQueueSource_PostPrivateMessage_MessageReceivedUnchanged()
+    {
+        var process = NativeProcesses.Create(1)[0];
+
+        try
+        {
+            (nint processWindow, int threadId) = NativeProcesses.GetWindowInformation(process);
+            const WindowMessage privateMessage = WindowMessage.User + 1;
+            bool receivedPrivateMessage = false;
+
+            await using (var source = new MessageQueueSource(GetMessage, threadId))
+            {
+                await source.StartAsync();
+
+                User32.PostMessage(processWindow, privateMessage, new IntPtr(42), new IntPtr(-7));
+                _mre.Wait(TimeSpan.FromSeconds(3));
+            }
+
+            Assert.True(receivedPrivateMessage);
+
+            ProcedureResult GetMessage(ref uint msg, ref IntPtr wParam, ref IntPtr lParam)
+            {
+                if ((WindowMessage) msg == privateMessage && wParam == 42 && lParam == -7)
+                {
+                    receivedPrivateMessage = true;
+                    _mre.Set();
+                }
+
+                return new ProcedureResult(IntPtr.Zero, true);
+            }
+        }
+        finally
+        {
+            process.Kill();
+        }
+    }
+
+    [Fact]
+    public async Task MessageQueueSource_PeekedMessage_OnlyRemovalReceived()
+    {
+        var process = NativeProcesses.Create(1)[0];
+
+        try
+        {
+            (nint processWindow, int threadId) = NativeProcesses.GetWindowInformation(process);
+            int receivedCount = 0;
+
+            await using (var source = new MessageQueueSource(GetMessage, threadId))
+            {
+                await source.StartAsync();
+
+                User32.PostMessage(processWindow, PEEK_REQUEST_MESSAGE, IntPtr.Zero, IntPtr.Zero);
+                _mre.Wait(TimeSpan.FromSeconds(3));
+            }
+
+            Assert.Equal(1, receivedCount);
+
+            ProcedureResult GetMessage(ref uint msg, ref IntPtr wParam, ref IntPtr lParam)
+            {
+                if ((WindowMessage) msg == PEEKED_MESSAGE)
+                {
+                    receivedCount++;
+                    _mre.Set();
+                }
+
+                return new ProcedureResult(IntPtr.Zero, true);
+            }
+        }
+        finally
+        {
+            process.Kill();
+        }
+    }
+
+    [Fact]
+    public async Task MessageQueueSource_ObservePeeks_PeekReceivedBeforeRemoval()
+    {
+        var process = NativeProcesses.Create(1)[0];
+
+        try
+        {
+            (nint processWindow, int threadId) = NativeProcesses.GetWindowInformation(process);
+            int peekedCount = 0;
+            int peekedCountAtRemoval = -1;
+
+            await using (var source = new MessageQueueSource(GetMessage, PeekMessage, threadId))
+            {
+                await source.StartAsync();
+
+                User32.PostMessage(processWindow, PEEK_REQUEST_MESSAGE, IntPtr.Zero, IntPtr.Zero);
+                _mre.Wait(TimeSpan.FromSeconds(3));
+            }
+
+            Assert.NotEqual(0, peekedCount);
+            Assert.Equal(peekedCount, peekedCountAtRemoval);
+
+            ProcedureResult GetMessage(ref uint msg, ref IntPtr wParam, ref IntPtr lParam)
+            {
+                if ((WindowMessage) msg == PEEKED_MESSAGE)
+                {
+                    peekedCountAtRemoval = peekedCount;
+                    _mre.Set();
+                }
+
+                return new ProcedureResult(IntPtr.Zero, true);
+            }
+
+            ProcedureResult PeekMessage(uint msg, IntPtr wParam, IntPtr lParam)
+            {
+                if ((WindowMessage) msg == PEEKED_MESSAGE)
+                    peekedCount++;
+
+                return new ProcedureResult(IntPtr.Zero, true);
+            }
+        }
+        finally
+        {
+            process.Kill();
+        }
+    }
+
     [Fact]
     public async Task ExternalWindowWrapper_SendActivate_MessageReceived()
     {
@@ -100,6 +226,32 @@ public class MessageTests : IDisposable
         }
     }
 
+    [Fact]
+    public async Task MessagePumpWatchdog_RespondingThread_NoStallsDetected()
+    {
+        var process = NativeProcesses.Create(1)[0];
+
+        try
+        {
+            (nint _, int threadId) = NativeProcesses.GetWindowInformation(process);
+
+            using (var watchdog = new MessagePumpWatchdog(TimeSpan.FromMilliseconds(500)))
+            {
+                Assert.True(watchdog.Watch(threadId));
+
+                watchdog.Check();
+                await Task.Delay(TimeSpan.FromMilliseconds(750));
+
+                Assert.Empty(watchdog.Check());
+                Assert.Equal(0, watchdog.Histogram.TotalCount);
+            }
+        }
+        finally
+        {
+            process.Kill();
+        }
+    }
+
     public void Dispose()
     {
         _mre.Dispose();
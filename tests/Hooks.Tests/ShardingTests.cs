@@ -0,0 +1,168 @@
+﻿// -----------------------------------------------------------------------
+// <copyright>
+//      Created by Matt Weber <matt@badecho.com>
+//      Copyright @ 2026 Bad Echo LLC. All rights reserved.
+//
+//      Bad Echo Technologies are licensed under the
+//      GNU Affero General Public License v3.0.
+//
+//      See accompanying file LICENSE.md or a copy at:
+//      https://www.gnu.org/licenses/agpl-3.0.html
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System.Collections.Concurrent;
+using BadEcho.Hooks.Interop;
+using BadEcho.Interop;
+
+namespace BadEcho.Hooks.Tests;
+
+[Collection("HookTestsCollection")]
+public class ShardingTests
+{
+    private const int MAX_SHARDS = 8;
+    private const int SHARD_COUNT = 4;
+    private const int MESSAGE_COUNT = 64;
+    private const WindowMessage SHARDED_MESSAGE = WindowMessage.User + 1;
+
+    public ShardingTests()
+    {   // Required for test runner to see BadEcho.Hooks.Native.dll.
+        Kernel32.AddDllDirectory(Environment.CurrentDirectory);
+    }
+
+    [Theory]
+    [InlineData(ShardingPolicy.Thread, 1)]
+    [InlineData(ShardingPolicy.Window, 1)]
+    [InlineData(ShardingPolicy.RoundRobin, SHARD_COUNT)]
+    public async Task ShardedSource_SendMessages_DistributedByPolicy(ShardingPolicy policy, int expectedDestinationCount)
+    {
+        var process = NativeProcesses.Create(1)[0];
+
+        try
+        {
+            (nint processWindow, int threadId) = NativeProcesses.GetWindowInformation(process);
+
+            await using var source = new ShardedSource(threadId, SHARD_COUNT, policy);
+
+            await source.StartAsync();
+
+            // Hook events from a WH_CALLWNDPROC hook procedure are sent synchronously, so each one has been handled by the
+            // time the message it was intercepted from has been processed.
+            for (int i = 0; i < MESSAGE_COUNT; i++)
+            {
+                User32.SendMessage(processWindow, SHARDED_MESSAGE, new IntPtr(i), IntPtr.Zero);
+            }
+
+            await source.StopAsync();
+
+            var eventsByDestination = source.Events.GroupBy(e => e.Destination).ToList();
+
+            Assert.Equal(MESSAGE_COUNT, source.Events.Count);
+            Assert.Equal(expectedDestinationCount, eventsByDestination.Count);
+            // Events sharing a destination are always handled in the order they were sent, whatever the policy.
+            Assert.All(eventsByDestination,
+                       d => Assert.Equal(d.Select(e => e.Sequence).Order(), d.Select(e => e.Sequence)));
+        }
+        finally
+        {
+            process.Kill();
+        }
+    }
+
+    [Fact]
+    public void ShardedSource_MoreThanMaxShards_ThrowsException()
+    {
+        Assert.Throws<ArgumentOutOfRangeException>(() => new ShardedSource(0, MAX_SHARDS + 1, ShardingPolicy.RoundRobin));
+    }
+
+    [Fact]
+    public async Task ShardedSource_MaxShards_EveryShardReceivesEvents()
+    {
+        var process = NativeProcesses.Create(1)[0];
+
+        try
+        {
+            (nint processWindow, int threadId) = NativeProcesses.GetWindowInformation(process);
+
+            await using var source = new ShardedSource(threadId, MAX_SHARDS, ShardingPolicy.RoundRobin);
+
+            await source.StartAsync();
+
+            for (int i = 0; i < MESSAGE_COUNT; i++)
+            {
+                User32.SendMessage(processWindow, SHARDED_MESSAGE, new IntPtr(i), IntPtr.Zero);
+            }
+
+            await source.StopAsync();
+
+            Assert.Equal(MAX_SHARDS, source.Events.Select(e => e.Destination).Distinct().Count());
+        }
+        finally
+        {
+            process.Kill();
+        }
+    }
+
+    [Fact]
+    public async Task AddShardedHook_MoreThanMaxDestinations_ReturnsFalse()
+    {
+        var pumps = new List<MessageOnlyExecutor>();
+        var process = NativeProcesses.Create(1)[0];
+
+        try
+        {
+            for (int i = 0; i < MAX_SHARDS + 1; i++)
+            {
+                var pump = new MessageOnlyExecutor();
+
+                pumps.Add(pump);
+                await pump.StartAsync();
+                Assert.NotNull(pump.Window);
+            }
+
+            IntPtr[] destinations = pumps.Select(p => p.Window!.Handle.DangerousGetHandle()).ToArray();
+            int threadId = process.Threads[0].Id;
+
+            Assert.False(Native.AddShardedHook(HookType.CallWindowProcedure,
+                                               destinations,
+                                               destinations.Length,
+                                               ShardingPolicy.RoundRobin,
+                                               threadId,
+                                               HookOptions.None));
+
+            Assert.True(Native.AddShardedHook(HookType.CallWindowProcedure,
+                                              destinations,
+                                              MAX_SHARDS,
+                                              ShardingPolicy.RoundRobin,
+                                              threadId,
+                                              HookOptions.None));
+
+            Assert.True(Native.RemoveHook(HookType.CallWindowProcedure, threadId));
+        }
+        finally
+        {
+            process.Kill();
+
+            foreach (MessageOnlyExecutor pump in pumps)
+            {
+                pump.Dispose();
+            }
+        }
+    }
+
+    private sealed class ShardedSource : HookSource
+    {
+        public ShardedSource(int threadId, int shardCount, ShardingPolicy shardingPolicy)
+            : base(HookType.CallWindowProcedure, threadId, HookOptions.None, shardCount, shardingPolicy)
+        { }
+
+        public ConcurrentQueue<(nint Destination, long Sequence)> Events
+        { get; } = new();
+
+        protected override void OnHookEvent(nint hWnd, uint msg, nint wParam, nint lParam)
+        {   // The window handle is that of the destination window that received the hook event.
+            if ((WindowMessage) msg == SHARDED_MESSAGE)
+                Events.Enqueue((hWnd, wParam));
+        }
+    }
+}
@@ -3,6 +3,10 @@
 
 namespace
 {
+	// Asks the window to queue PeekedMessage and examine it without removing it, so tests can observe how hooks treat peeks.
+	constexpr UINT PeekRequestMessage = WM_USER + 0x10;
+	constexpr UINT PeekedMessage = WM_USER + 0x11;
+
 	LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 	{
 		switch (message) {
@@ -14,6 +18,14 @@ namespace
 			break;
 		}
 
+		case PeekRequestMessage: {
+
+			MSG peekedMsg;
+			PostMessage(hWnd, PeekedMessage, 0, 0);
+			PeekMessage(&peekedMsg, hWnd, PeekedMessage, PeekedMessage, PM_NOREMOVE);
+			break;
+		}
+
 		case WM_DESTROY: {
 			PostQuitMessage(0);
 			break;